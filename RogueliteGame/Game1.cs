@@ -3,6 +3,8 @@ using Microsoft.Xna.Framework.Graphics;
 using Microsoft.Xna.Framework.Input;
 using RogueliteGame.Networking;
 using RogueliteGame.Rendering;
+using RogueliteGame.Systems;
+using RogueliteGame.World;
 using System;
 using System.Collections.Generic;
 using System.Linq;
@@ -23,6 +25,7 @@ namespace RogueliteGame
         // Rendering
         private Texture2D pixelTexture;
         private Camera camera;
+        private DungeonRenderSystem dungeonRenderer;   // Null until the server sends the seed
 
         // Sprite textures
         private Texture2D playerSprite;
@@ -148,6 +151,14 @@ namespace RogueliteGame
                                 playerNames[assignedId] = playerName;
                                 Console.WriteLine($"[Game1] We are Player {assignedId} ({playerName})");
                             };
+
+                            networkClient.OnDungeonSeedReceived += (uint seed) =>
+                            {
+                                Dungeon dungeon = new DungeonGenerator(seed).Generate(
+                                    Protocol.DungeonWidth, Protocol.DungeonHeight);
+                                dungeonRenderer = new DungeonRenderSystem(dungeon, GraphicsDevice);
+                                Console.WriteLine($"[Game1] Dungeon seed {seed}");
+                            };
                             
                             networkClient.Connect("127.0.0.1", 12345, playerName);
                             currentState = GameState.Playing;
@@ -318,6 +329,8 @@ namespace RogueliteGame
 
             _spriteBatch.Begin(transformMatrix: camera.GetTransformMatrix());
 
+            dungeonRenderer?.Draw(_spriteBatch,
+                new Point((int)Protocol.MapMinX, (int)Protocol.MapMinY));
             DrawGrid();
 
             foreach (var entity in entities.Values)
@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Generic;
 using System.Net;
 using System.Net.Sockets;
 using Microsoft.Xna.Framework;
@@ -11,13 +12,31 @@ namespace RogueliteGame.Networking
         private IPEndPoint serverEndPoint;
         private bool connected;
         
+        // Recently decoded states by tick, used as delta baselines (matches the server ring).
+        // A tick is only a baseline once all of its fragments have arrived.
+        private const int StateHistorySize = 32;
+        private StateMessage?[] stateHistory = new StateMessage?[StateHistorySize];
+        private uint[] fragmentsReceived = new uint[StateHistorySize];   // Bit per fragment index
+        private int[] fragmentCount = new int[StateHistorySize];         // 0 until the last fragment arrives
+        private bool[] stateComplete = new bool[StateHistorySize];
+        
+        // What we show: every fragment is applied as it arrives, so a lost
+        // fragment only leaves its ID range a tick behind
+        private EntityState[] displayEntities = new EntityState[0];
+        private uint displayTick;
+        private Dictionary<uint, string> newPlayerNames = new Dictionary<uint, string>();  // Since the last Update
+        
         public StateMessage LastState { get; private set; }
         public bool HasNewState { get; private set; }
         public uint PlayerId { get; private set; }
+        public uint DungeonSeed { get; private set; }
         
         // NEW: Event when server assigns our player ID
         public event Action<uint> OnPlayerIdAssigned;
 
+        // Seed of the server's dungeon (generated identically on both sides)
+        public event Action<uint> OnDungeonSeedReceived;
+
         public NetworkClient()
         {
             udpClient = null;
@@ -39,6 +58,10 @@ namespace RogueliteGame.Networking
                 udpClient.Send(connectPacket, connectPacket.Length, serverEndPoint);
                 
                 connected = true;
+                Array.Clear(stateHistory, 0, stateHistory.Length);
+                Array.Clear(stateComplete, 0, stateComplete.Length);
+                displayEntities = new EntityState[0];
+                displayTick = 0;
                 Console.WriteLine($"Connected to server at {serverIp}:{serverPort}");
             }
             catch (Exception ex)
@@ -70,11 +93,12 @@ namespace RogueliteGame.Networking
             if (!connected || udpClient == null) return;
 
             HasNewState = false;
+            newPlayerNames = new Dictionary<uint, string>();
 
             try
             {
-                // Non-blocking receive
-                if (udpClient.Available > 0)
+                // Non-blocking receive (a tick's state may take several packets)
+                while (udpClient.Available > 0)
                 {
                     IPEndPoint remoteEndPoint = new IPEndPoint(IPAddress.Any, 0);
                     byte[] receivedData = udpClient.Receive(ref remoteEndPoint);
@@ -97,11 +121,19 @@ namespace RogueliteGame.Networking
                             
                             // Trigger event
                             OnPlayerIdAssigned?.Invoke(PlayerId);
+
+                            if (receivedData.Length >= 9)
+                            {
+                                DungeonSeed = ((uint)receivedData[5] << 24) |
+                                              ((uint)receivedData[6] << 16) |
+                                              ((uint)receivedData[7] << 8) |
+                                              ((uint)receivedData[8]);
+                                OnDungeonSeedReceived?.Invoke(DungeonSeed);
+                            }
                         }
                         else if (msgType == MessageType.State)
                         {
-                            LastState = Protocol.DeserializeState(receivedData, receivedData.Length);
-                            HasNewState = true;
+                            HandleState(receivedData);
                         }
                     }
                 }
@@ -112,6 +144,67 @@ namespace RogueliteGame.Networking
             }
         }
 
+        // Decode one STATE fragment, add it to its tick and ACK the tick once complete
+        private void HandleState(byte[] data)
+        {
+            // Decode against the state the server says it used; if we no longer
+            // have it, drop the packet (no ACK, so the server falls back)
+            uint baselineTick = Protocol.PeekBaselineTick(data, data.Length);
+            StateMessage? baseline = null;
+            if (baselineTick != 0)
+            {
+                int baseSlot = (int)(baselineTick % StateHistorySize);
+                baseline = stateHistory[baseSlot];
+                if (baseline == null || baseline.Value.Tick != baselineTick || !stateComplete[baseSlot]) return;
+            }
+            
+            StateMessage fragment = Protocol.DeserializeState(data, data.Length, baseline);
+            if (fragment.FragmentIndex >= Protocol.MaxFragments) return;
+            
+            // Assemble the tick
+            int slot = (int)(fragment.Tick % StateHistorySize);
+            StateMessage? pending = stateHistory[slot];
+            if (pending == null || pending.Value.Tick != fragment.Tick)
+            {
+                StateMessage fresh = fragment;
+                fresh.Entities = new EntityState[0];
+                pending = fresh;
+                fragmentsReceived[slot] = 0;
+                fragmentCount[slot] = 0;
+                stateComplete[slot] = false;
+            }
+            uint bit = 1u << fragment.FragmentIndex;
+            if (stateComplete[slot] || (fragmentsReceived[slot] & bit) != 0) return;
+            
+            StateMessage assembled = pending.Value;
+            assembled.Entities = Protocol.ApplyFragment(assembled.Entities, fragment);
+            stateHistory[slot] = assembled;
+            fragmentsReceived[slot] |= bit;
+            if (fragment.LastFragment) fragmentCount[slot] = fragment.FragmentIndex + 1;
+            
+            int count = fragmentCount[slot];
+            if (count > 0 && fragmentsReceived[slot] == (uint)((1UL << count) - 1))
+            {
+                stateComplete[slot] = true;
+                byte[] ackPacket = Protocol.SerializeAck(fragment.Tick);
+                udpClient.Send(ackPacket, ackPacket.Length, serverEndPoint);
+            }
+            
+            // Names are only sent until acknowledged, so keep every one we see
+            foreach (var kvp in fragment.PlayerNames)
+                newPlayerNames[kvp.Key] = kvp.Value;
+            
+            // Show it right away (fragments older than what's shown are ignored)
+            if (fragment.Tick < displayTick) return;
+            displayTick = fragment.Tick;
+            displayEntities = Protocol.ApplyFragment(displayEntities, fragment);
+            StateMessage shown = fragment;
+            shown.Entities = displayEntities;
+            shown.PlayerNames = newPlayerNames;
+            LastState = shown;
+            HasNewState = true;
+        }
+
         // Disconnect from server
         public void Disconnect()
         {
@@ -13,7 +13,8 @@ namespace RogueliteGame.Networking
         State = 3,
         Ping = 4,
         Pong = 5,
-        Welcome = 6  // NEW: Server tells us our player ID
+        Welcome = 6,  // NEW: Server tells us our player ID
+        Ack = 7       // We tell the server the last state we decoded
     }
 
     // Input keys (same as C protocol)
@@ -54,6 +55,12 @@ namespace RogueliteGame.Networking
         public uint Tick;
         public EntityState[] Entities;
         
+        // Fragment of the tick's state: covers entity IDs RangeStart..RangeLast
+        public byte FragmentIndex;
+        public bool LastFragment;
+        public uint RangeStart;
+        public uint RangeLast;
+        
         // Wave system
         public byte CurrentWave;
         public bool WaveActive;
@@ -65,6 +72,29 @@ namespace RogueliteGame.Networking
 
     public static class Protocol
     {
+        // STATE delta layout (same as C protocol)
+        private const int StateHeaderSize = 24;
+        private const byte LastFragmentBit = 0x80;
+        public const int MaxFragments = 32;
+        private const byte DeltaRemoved = 0x01;
+        private const byte DeltaType = 0x02;
+        private const byte DeltaPosition = 0x04;
+        private const byte DeltaHealth = 0x08;
+        private const byte DeltaMaxHealth = 0x10;
+        private const byte DeltaRotation = 0x20;
+        
+        // Bit-packed entity fields (same as C protocol)
+        private const int DeltaFlagBits = 6;
+        private const int TypeBits = 2;
+        public const float MapMinX = -400.0f;
+        public const float MapMinY = -300.0f;
+        public const int DungeonWidth = 50;         // Tiles (same as C DUNGEON_WIDTH)
+        public const int DungeonHeight = 37;
+        private const float PositionScale = 8.0f;   // 1/8 px
+        private const int PositionBits = 14;
+        private const int RotationBits = 9;
+        private static readonly int[] IdGapBits = { 4, 8, 16, 32 };
+
         // Serialize CONNECT message
         public static byte[] SerializeConnect(string playerName)
         {
@@ -106,90 +136,213 @@ namespace RogueliteGame.Networking
             return buffer;
         }
 
-        // Deserialize STATE message
-        public static StateMessage DeserializeState(byte[] buffer, int length)
+        // Serialize ACK message (tells the server which state to delta against)
+        public static byte[] SerializeAck(uint tick)
         {
-            if (length < 6) throw new Exception("Buffer too small");
+            byte[] buffer = new byte[5];
+            buffer[0] = (byte)MessageType.Ack;
+            WriteUInt32(buffer, 1, tick);
+            return buffer;
+        }
+
+        // Tick of the state a STATE packet was encoded against (0 = full state)
+        public static uint PeekBaselineTick(byte[] buffer, int length)
+        {
+            if (length < StateHeaderSize) return 0;
+            return ReadUInt32(buffer, 5);
+        }
+
+        // Deserialize one STATE fragment: applies its delta records to the
+        // baseline entities in its ID range (baseline null for a full state).
+        // Entities are kept sorted by ID.
+        public static StateMessage DeserializeState(byte[] buffer, int length, StateMessage? baseline)
+        {
+            if (length < StateHeaderSize + 2) throw new Exception("Buffer too small");
             
             StateMessage state = new StateMessage();
-            int offset = 0;
-            
-            // Skip message type
-            offset++;
+            int offset = 1;  // Skip message type
             
             // Tick number (4 bytes)
             state.Tick = ReadUInt32(buffer, offset);
             offset += 4;
             
-            // Entity count (1 byte)
-            byte entityCount = buffer[offset++];
-            state.Entities = new EntityState[entityCount];
+            // Baseline tick (4 bytes)
+            uint baselineTick = ReadUInt32(buffer, offset);
+            offset += 4;
+            if (baselineTick != 0 && (baseline == null || baseline.Value.Tick != baselineTick))
+                throw new Exception($"Missing baseline {baselineTick}");
+            
+            byte fragment = buffer[offset++];
+            state.FragmentIndex = (byte)(fragment & ~LastFragmentBit);
+            state.LastFragment = (fragment & LastFragmentBit) != 0;
+            
+            // Wave system data
+            state.CurrentWave = buffer[offset++];
+            state.WaveActive = buffer[offset++] != 0;
+            state.WaveCountdown = ReadFloat(buffer, offset);
+            offset += 4;
+            
+            // ID range this fragment covers
+            state.RangeStart = ReadUInt32(buffer, offset);
+            state.RangeLast = ReadUInt32(buffer, offset + 4);
+            offset += 8;
             
-            // Each entity (22 bytes each: id:4 + type:1 + pos:8 + hp:2 + maxhp:2 + rot:4 + active:1)
-            for (int i = 0; i < entityCount; i++)
+            List<EntityState> baseEntities = new List<EntityState>();
+            if (baselineTick != 0)
             {
-                if (offset + 22 > length) break;
-                
-                EntityState entity = new EntityState();
-                
-                // Entity ID (4 bytes)
-                entity.EntityId = ReadUInt32(buffer, offset);
-                offset += 4;
+                foreach (EntityState e in baseline.Value.Entities)
+                {
+                    if (e.EntityId >= state.RangeStart && e.EntityId <= state.RangeLast)
+                        baseEntities.Add(e);
+                }
+            }
+            
+            // Entity records, merged with the baseline (both in ID order)
+            ushort recordCount = (ushort)ReadInt16(buffer, offset);
+            offset += 2;
+            
+            List<EntityState> entities = new List<EntityState>(baseEntities.Count + recordCount);
+            BitReader reader = new BitReader(buffer, offset, length);
+            uint id = 0;
+            int b = 0;
+            for (int i = 0; i < recordCount; i++)
+            {
+                // ID as a gap from the previous record, then which fields follow
+                int gapClass = (int)reader.Read(2);
+                uint gap = reader.Read(IdGapBits[gapClass]);
+                id = (i == 0) ? gap : id + 1 + gap;
+                uint flags = reader.Read(DeltaFlagBits);
                 
-                // Entity type (1 byte)
-                entity.Type = (EntityType)buffer[offset++];
+                // Baseline entities before this ID are unchanged
+                while (b < baseEntities.Count && baseEntities[b].EntityId < id)
+                    entities.Add(baseEntities[b++]);
                 
-                // Position (8 bytes)
-                entity.X = ReadFloat(buffer, offset);
-                offset += 4;
-                entity.Y = ReadFloat(buffer, offset);
-                offset += 4;
+                EntityState entity;
+                if (b < baseEntities.Count && baseEntities[b].EntityId == id)
+                {
+                    entity = baseEntities[b++];
+                }
+                else
+                {
+                    entity = new EntityState();
+                    entity.EntityId = id;
+                    entity.Active = true;
+                }
                 
-                // Health (2 bytes)
-                entity.Health = ReadInt16(buffer, offset);
-                offset += 2;
+                if ((flags & DeltaRemoved) != 0) continue;
                 
-                // Max Health (2 bytes)
-                entity.MaxHealth = ReadInt16(buffer, offset);
-                offset += 2;
+                if ((flags & DeltaType) != 0)
+                {
+                    entity.Type = (EntityType)reader.Read(TypeBits);
+                }
+                if ((flags & DeltaPosition) != 0)
+                {
+                    entity.X = MapMinX + reader.Read(PositionBits) / PositionScale;
+                    entity.Y = MapMinY + reader.Read(PositionBits) / PositionScale;
+                }
+                if ((flags & DeltaMaxHealth) != 0)
+                {
+                    entity.MaxHealth = (short)reader.Read(16);
+                }
+                if ((flags & DeltaHealth) != 0)
+                {
+                    // Sent in just enough bits to hold MaxHealth
+                    entity.Health = (short)reader.Read(HealthBits(entity.MaxHealth));
+                }
+                if ((flags & DeltaRotation) != 0)
+                {
+                    entity.Rotation = reader.Read(RotationBits) * (MathF.PI * 2.0f / (1 << RotationBits));
+                }
                 
-                // Rotation (4 bytes) - NEW
-                entity.Rotation = ReadFloat(buffer, offset);
+                entities.Add(entity);
+            }
+            offset = reader.ByteOffset;  // Entity section is padded to a byte
+            
+            // Rest of the baseline is unchanged
+            while (b < baseEntities.Count)
+                entities.Add(baseEntities[b++]);
+            state.Entities = entities.ToArray();
+            
+            // Player names: only new or changed ones are sent, so callers keep
+            // their own name table.
+            state.PlayerNames = new Dictionary<uint, string>();
+            if (offset + 2 > length) throw new Exception("Truncated player list");
+            ushort playerCount = (ushort)ReadInt16(buffer, offset);
+            offset += 2;
+            for (int i = 0; i < playerCount && offset + 5 <= length; i++)
+            {
+                uint playerId = ReadUInt32(buffer, offset);
                 offset += 4;
                 
-                // Active (1 byte)
-                entity.Active = buffer[offset++] != 0;
+                byte nameLength = buffer[offset++];
+                if (nameLength > 31 || offset + nameLength > length) break;
                 
-                state.Entities[i] = entity;
+                string name = System.Text.Encoding.ASCII.GetString(buffer, offset, nameLength);
+                offset += nameLength;
+                
+                state.PlayerNames[playerId] = name;
             }
             
-            // Wave system data (if available)
-            if (offset + 6 <= length)
+            return state;
+        }
+
+        // Bits used for a health value with this max
+        private static int HealthBits(short maxHealth)
+        {
+            int bits = 1;
+            while (bits < 16 && (1 << bits) <= maxHealth) bits++;
+            return bits;
+        }
+
+        // Reads MSB-first bit fields (the entity section of a STATE)
+        private class BitReader
+        {
+            private readonly byte[] buffer;
+            private int position;   // In bits
+            private readonly int end;
+
+            public BitReader(byte[] buffer, int byteOffset, int length)
             {
-                state.CurrentWave = buffer[offset++];
-                state.WaveActive = buffer[offset++] != 0;
-                state.WaveCountdown = ReadFloat(buffer, offset);
-                offset += 4;
+                this.buffer = buffer;
+                position = byteOffset * 8;
+                end = length * 8;
             }
-            
-            // NEW: Player names (if available)
-            state.PlayerNames = new Dictionary<uint, string>();
-            if (offset + 1 <= length)
+
+            public int ByteOffset => (position + 7) / 8;
+
+            public uint Read(int count)
             {
-                byte playerCount = buffer[offset++];
-                for (int i = 0; i < playerCount && offset + 36 <= length; i++)
+                if (position + count > end) throw new Exception("Truncated entity record");
+                uint value = 0;
+                while (count > 0)
                 {
-                    uint playerId = ReadUInt32(buffer, offset);
-                    offset += 4;
-                    
-                    string name = System.Text.Encoding.ASCII.GetString(buffer, offset, 32).TrimEnd('\0');
-                    offset += 32;
-                    
-                    state.PlayerNames[playerId] = name;
+                    int used = position & 7;
+                    int take = Math.Min(8 - used, count);
+                    uint bits = (uint)(buffer[position >> 3] >> (8 - used - take)) & ((1u << take) - 1);
+                    value = (value << take) | bits;
+                    position += take;
+                    count -= take;
                 }
+                return value;
             }
+        }
+
+        // Replace the entities in a fragment's ID range with the fragment's.
+        // Applying every fragment of a tick to an empty array rebuilds the full state.
+        public static EntityState[] ApplyFragment(EntityState[] target, StateMessage fragment)
+        {
+            if (fragment.RangeStart > fragment.RangeLast) return target;  // Player names only
             
-            return state;
+            List<EntityState> merged = new List<EntityState>(target.Length + fragment.Entities.Length);
+            int i = 0;
+            while (i < target.Length && target[i].EntityId < fragment.RangeStart)
+                merged.Add(target[i++]);
+            merged.AddRange(fragment.Entities);
+            while (i < target.Length && target[i].EntityId <= fragment.RangeLast)
+                i++;
+            while (i < target.Length)
+                merged.Add(target[i++]);
+            return merged.ToArray();
         }
 
         // Helper: Write uint32 to buffer (network byte order). Htnol in C# is not available, so we manually convert to big-endian format.
@@ -17,7 +17,7 @@ namespace RogueliteGame.World
         }
 
         
-        public void Split(Random rng, int minSize)
+        public void Split(Rng rng, int minSize)
         {
             // minsize is liek saying a room must be at least this big, so splitting equtes to creating two rooms of at least this size.
             // Stop if too small to split partition (is a rectangle of space created by BSP splitting).
@@ -64,7 +64,7 @@ namespace RogueliteGame.World
             Right.Split(rng, minSize);
         }
 
-        public void CreateRooms(Random rng, int minRoomSize, int maxRoomSize)
+        public void CreateRooms(Rng rng, int minRoomSize, int maxRoomSize)
         {
             // If this is a leaf node (no children), create a room
             if (Left == null && Right == null)
@@ -85,7 +85,7 @@ namespace RogueliteGame.World
             }
         }
 
-        public Rectangle GetRoom()
+        public Rectangle GetRoom(Rng rng)
         {
             if (Room.HasValue)
                 return Room.Value;
@@ -94,13 +94,13 @@ namespace RogueliteGame.World
             Rectangle rightRoom = default;
 
             if (Left != null)
-                leftRoom = Left.GetRoom();
+                leftRoom = Left.GetRoom(rng);
             if (Right != null)
-                rightRoom = Right.GetRoom();
+                rightRoom = Right.GetRoom(rng);
 
-            // Return a random room from children
+            // Return a random room from children (seeded, so the server picks the same one)
             if (leftRoom != default && rightRoom != default)
-                return new Random().Next(2) == 0 ? leftRoom : rightRoom;
+                return rng.Next(2) == 0 ? leftRoom : rightRoom;
             
             return leftRoom != default ? leftRoom : rightRoom;
         }
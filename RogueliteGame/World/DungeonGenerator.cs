@@ -6,11 +6,13 @@ namespace RogueliteGame.World
 {
     public class DungeonGenerator
     {
-        private Random rng;
+        // Same generator and draw order as the server's dungeon.c: the
+        // server sends only the seed and both sides build the same map
+        private Rng rng;
 
-        public DungeonGenerator(int seed)
+        public DungeonGenerator(uint seed)
         {
-            rng = new Random(seed);
+            rng = new Rng(seed);
         }
 
         public Dungeon Generate(int width, int height)
@@ -61,8 +63,8 @@ namespace RogueliteGame.World
 
             if (node.Left != null && node.Right != null)
             {
-                Rectangle leftRoom = node.Left.GetRoom();
-                Rectangle rightRoom = node.Right.GetRoom();
+                Rectangle leftRoom = node.Left.GetRoom(rng);
+                Rectangle rightRoom = node.Right.GetRoom(rng);
 
                 Point leftCenter = leftRoom.Center;
                 Point rightCenter = rightRoom.Center;
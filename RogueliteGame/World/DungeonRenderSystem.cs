@@ -17,7 +17,8 @@ namespace RogueliteGame.Systems
             pixelTexture.SetData(new[] { Color.White });
         }
 
-        public void Draw(SpriteBatch spriteBatch)
+        // 'origin' is the world position of tile (0, 0)
+        public void Draw(SpriteBatch spriteBatch, Point origin)
         {
             for (int y = 0; y < dungeon.Height; y++)
             {
@@ -27,8 +28,8 @@ namespace RogueliteGame.Systems
                    Color color = tile == TileType.Wall ? Color.DarkGray : Color.Gray;
                     
                     Rectangle rect = new Rectangle(
-                        x * Dungeon.TileSize,
-                        y * Dungeon.TileSize,
+                        origin.X + x * Dungeon.TileSize,
+                        origin.Y + y * Dungeon.TileSize,
                         Dungeon.TileSize,
                         Dungeon.TileSize
                     );
@@ -0,0 +1,47 @@
+namespace RogueliteGame.World
+{
+    // PCG32 (XSH-RR), a port of the server's rng.c. Dungeon generation
+    // draws from this instead of System.Random so the client rebuilds
+    // exactly the map the server generated from the same seed.
+    public class Rng
+    {
+        private const ulong Multiplier = 6364136223846793005UL;
+
+        private ulong state;
+        private ulong inc;
+
+        public Rng(ulong seed, ulong stream = 0)
+        {
+            state = 0;
+            inc = (stream << 1) | 1UL;
+            NextUInt();
+            state += seed;
+            NextUInt();
+        }
+
+        public uint NextUInt()
+        {
+            ulong old = state;
+            state = unchecked(old * Multiplier + inc);
+            uint xorshifted = (uint)(((old >> 18) ^ old) >> 27);
+            int rot = (int)(old >> 59);
+            return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+        }
+
+        // Integer in [min, max) (min if max <= min), same as rng_int on the server
+        public int Next(int min, int max)
+        {
+            if (max <= min)
+                return min;
+
+            uint span = (uint)(max - min);
+            return min + (int)(((ulong)NextUInt() * span) >> 32);
+        }
+
+        // Integer in [0, max)
+        public int Next(int max)
+        {
+            return Next(0, max);
+        }
+    }
+}
@@ -0,0 +1,137 @@
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L  // sysconf under -std=c11
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/ai.h"
+#include "../src/rng.h"
+#include "../src/protocol.h"
+#include "../src/timing.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+    #define NULL_DEVICE "NUL"
+#else
+    #include <unistd.h>
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+// ai_update_all cost: first against player count on one thread (each
+// enemy's nearest-player query should stay flat), then scaling with
+// worker threads: the same world is simulated for TICKS ticks at 1, 2,
+// 4 ... N threads (N = cores, or argv[1]), timing only the AI phase.
+// Every thread count must end in the same state.
+// Usage: bench_ai [max_threads]
+
+#define TICKS 120
+#define SEED 1234
+#define PLAYERS 4      // For the thread scaling runs
+
+static int core_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+#endif
+}
+
+// Players and enemies scattered over the map; enemies near a player chase
+// and shoot, the rest idle and wander
+static void populate(EntityManager* em, int enemy_count, int player_count) {
+    Rng rng;
+    rng_seed(&rng, SEED, 0);
+    for (int i = 0; i < player_count; i++) {
+        float x = rng_range(&rng, MAP_MIN_X, MAP_MAX_X);
+        float y = rng_range(&rng, MAP_MIN_Y, MAP_MAX_Y);
+        entity_create(em, ENTITY_TYPE_PLAYER, vector2_create(x, y));
+    }
+    for (int i = 0; i < enemy_count; i++) {
+        float x = rng_range(&rng, MAP_MIN_X, MAP_MAX_X);
+        float y = rng_range(&rng, MAP_MIN_Y, MAP_MAX_Y);
+        entity_create(em, ENTITY_TYPE_ENEMY, vector2_create(x, y));
+    }
+}
+
+// FNV-1a over AI state, velocities and fired projectiles
+static uint64_t world_checksum(const EntityManager* em, const ProjectilePool* projectiles) {
+    uint64_t hash = 14695981039346656037ull;
+    const uint8_t* parts[] = {(const uint8_t*)em->ai, (const uint8_t*)em->vel_x, (const uint8_t*)em->vel_y};
+    size_t sizes[] = {sizeof(AIComponent), sizeof(float), sizeof(float)};
+    for (int p = 0; p < 3; p++) {
+        for (size_t b = 0; b < em->count * sizes[p]; b++) {
+            hash = (hash ^ parts[p][b]) * 1099511628211ull;
+        }
+    }
+    for (size_t i = 0; i < projectiles->count; i++) {
+        hash = (hash ^ projectiles->owner_id[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Returns ns per enemy per tick; *checksum gets the final state
+static double run(int enemy_count, int player_count, int threads, uint64_t* checksum) {
+    EntityManager em;
+    ProjectilePool projectiles;
+    AISystem ai;
+    entity_manager_init(&em, (size_t)(enemy_count + player_count));
+    projectile_pool_init(&projectiles, (size_t)enemy_count + 1);
+    Dungeon dungeon;
+    dungeon_generate(&dungeon, SEED, DUNGEON_WIDTH, DUNGEON_HEIGHT, MAP_MIN_X, MAP_MIN_Y);
+    ai_system_init(&ai, threads, &dungeon, MAP_MIN_X, MAP_MIN_Y, MAP_MAX_X, MAP_MAX_Y);
+    populate(&em, enemy_count, player_count);
+
+    float dt = 1.0f / 60.0f;
+    uint64_t ai_ns = 0;
+    for (int tick = 1; tick <= TICKS; tick++) {
+        uint64_t start = timing_now_ns();
+        ai_update_all(&ai, &em, &projectiles, dt, SEED, (uint32_t)tick);
+        ai_ns += timing_now_ns() - start;
+
+        entity_update_all(&em, dt);
+        entity_clamp_all(&em, MAP_MIN_X, MAP_MIN_Y, MAP_MAX_X, MAP_MAX_Y);
+    }
+
+    *checksum = world_checksum(&em, &projectiles);
+    ai_system_free(&ai);
+    dungeon_free(&dungeon);
+    projectile_pool_free(&projectiles);
+    entity_manager_free(&em);
+    return (double)ai_ns / ((double)enemy_count * TICKS);
+}
+
+int main(int argc, char** argv) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : core_count();
+    if (max_threads < 1) max_threads = 1;
+    if (max_threads > WORKER_POOL_MAX_THREADS) max_threads = WORKER_POOL_MAX_THREADS;
+
+    // Pool and manager setup log to stdout; results go to stderr
+    freopen(NULL_DEVICE, "w", stdout);
+    fprintf(stderr, "=== AI BENCHMARK (ai_update_all, %d ticks, %d cores) ===\n", TICKS, core_count());
+
+    int players[] = {1, 4, 16, 64, 256};
+    uint64_t unused;
+    for (int p = 0; p < 5; p++) {
+        fprintf(stderr, " 10000 enemies | %3d players  %6.2f ns/enemy\n",
+                players[p], run(10000, players[p], 1, &unused));
+    }
+
+    int sizes[] = {1000, 10000, 50000};
+    for (int s = 0; s < 3; s++) {
+        uint64_t serial_sum = 0;
+        double serial = run(sizes[s], PLAYERS, 1, &serial_sum);
+        fprintf(stderr, "%6d enemies |  1 thread   %6.2f ns/enemy\n", sizes[s], serial);
+
+        for (int threads = 2; threads <= max_threads; threads *= 2) {
+            uint64_t sum = 0;
+            double parallel = run(sizes[s], PLAYERS, threads, &sum);
+            fprintf(stderr, "%6d enemies | %2d threads  %6.2f ns/enemy | %5.2fx %s\n",
+                    sizes[s], threads, parallel, serial / parallel,
+                    sum == serial_sum ? "" : "(MISMATCH!)");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/game_loop.h"
+#include "../src/collision.h"
+
+#ifdef _WIN32
+    #define NULL_DEVICE "NUL"
+#else
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+// Compares collision_resolve_all (spatial hash broadphase) against the
+// original O(projectiles x entities) nested loop over the projectile pool; both include the
+// end-of-tick compaction. Results go to stderr;
+// stdout is discarded because the game code logs every hit.
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// The pre-broadphase nested loop, kept as the baseline
+static void collision_resolve_naive(GameState* game) {
+    EntityManager* em = &game->entity_manager;
+    ProjectilePool* pool = &game->projectiles;
+
+    for (size_t i = 0; i < pool->count; i++) {
+        if (!pool->active[i]) continue;
+
+        BoundingBox projectile_box;
+        projectile_box.x = pool->pos_x[i];
+        projectile_box.y = pool->pos_y[i];
+        projectile_box.width = PROJECTILE_SIZE;
+        projectile_box.height = PROJECTILE_SIZE;
+
+        for (size_t j = 0; j < em->count; j++) {
+            Entity* target = &em->entities[j];
+            if (!target->active) continue;
+            if (pool->owner_id[i] == target->id) continue;
+
+            if (collision_check_aabb(projectile_box, collision_get_bounds(em, target))) {
+                target->health -= 10;
+                pool->active[i] = false;
+
+                const char* target_type = (target->type == ENTITY_TYPE_PLAYER) ? "Player" : "Enemy";
+                printf("Projectile %u hit %s %u! HP: %d\n",
+                       pool->id[i], target_type, target->id, target->health);
+
+                if (target->health <= 0) {
+                    printf("%s %u destroyed!\n", target_type, target->id);
+                    target->active = false;
+
+                    for (int k = 0; k < game->config.max_clients; k++) {
+                        if (game->clients[k].connected &&
+                            game->clients[k].player_id == pool->owner_id[i]) {
+                            game->clients[k].kills++;
+                            break;
+                        }
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    entity_apply_commands(em);
+    projectile_pool_compact(pool);
+}
+
+// Fill the world with enemies plus one projectile per 10 entities
+static void populate(GameState* game, int entity_count) {
+    EntityManager* em = &game->entity_manager;
+    int projectile_count = entity_count / 10;
+    if (projectile_count < 1) projectile_count = 1;
+
+    srand(12345);
+    for (int i = 0; i < entity_count; i++) {
+        float x = MAP_MIN_X + (float)rand() / RAND_MAX * (MAP_MAX_X - MAP_MIN_X);
+        float y = MAP_MIN_Y + (float)rand() / RAND_MAX * (MAP_MAX_Y - MAP_MIN_Y);
+        if (i < projectile_count) {
+            projectile_spawn(&game->projectiles, vector2_create(x, y), vector2_create(0.0f, 0.0f), 0, 0.0f);
+        } else {
+            entity_create(em, ENTITY_TYPE_ENEMY, vector2_create(x, y));
+        }
+    }
+}
+
+// Checksum of the post-collision world, to prove both paths agree
+static long world_checksum(const GameState* game) {
+    const EntityManager* em = &game->entity_manager;
+    long sum = (long)em->count * 31 + (long)game->projectiles.count;
+    for (size_t i = 0; i < em->count; i++) {
+        sum += (long)em->entities[i].id * em->entities[i].health;
+    }
+    return sum;
+}
+
+// Copy of every EntityManager and ProjectilePool array, restored before each timed run
+typedef struct {
+    float* pos_x;
+    float* pos_y;
+    float* vel_x;
+    float* vel_y;
+    Entity* entities;
+    AIComponent* ai;
+    size_t count;
+    HandleTable handles;  // Slot arrays copied too, so removals can be replayed
+    ProjectilePool projectiles;
+} WorldSnapshot;
+
+static void handles_copy(HandleTable* dst, const HandleTable* src) {
+    size_t slots = src->slot_capacity;
+    memcpy(dst->dense, src->dense, slots * sizeof(uint32_t));
+    memcpy(dst->generation, src->generation, slots * sizeof(uint16_t));
+    dst->slot_count = src->slot_count;
+    dst->free_head = src->free_head;
+    dst->free_tail = src->free_tail;
+}
+
+static void pool_copy(ProjectilePool* dst, const ProjectilePool* src) {
+    size_t n = src->count;
+    memcpy(dst->pos_x, src->pos_x, n * sizeof(float));
+    memcpy(dst->pos_y, src->pos_y, n * sizeof(float));
+    memcpy(dst->vel_x, src->vel_x, n * sizeof(float));
+    memcpy(dst->vel_y, src->vel_y, n * sizeof(float));
+    memcpy(dst->rotation, src->rotation, n * sizeof(float));
+    memcpy(dst->id, src->id, n * sizeof(uint32_t));
+    memcpy(dst->owner_id, src->owner_id, n * sizeof(uint32_t));
+    memcpy(dst->active, src->active, n * sizeof(bool));
+    dst->count = n;
+    handles_copy(&dst->handles, &src->handles);
+}
+
+static void snapshot_take(WorldSnapshot* snap, const GameState* game) {
+    const EntityManager* em = &game->entity_manager;
+    size_t n = em->count;
+    snap->count = n;
+    snap->pos_x = malloc(n * sizeof(float));
+    snap->pos_y = malloc(n * sizeof(float));
+    snap->vel_x = malloc(n * sizeof(float));
+    snap->vel_y = malloc(n * sizeof(float));
+    snap->entities = malloc(n * sizeof(Entity));
+    snap->ai = malloc(n * sizeof(AIComponent));
+    memcpy(snap->pos_x, em->pos_x, n * sizeof(float));
+    memcpy(snap->pos_y, em->pos_y, n * sizeof(float));
+    memcpy(snap->vel_x, em->vel_x, n * sizeof(float));
+    memcpy(snap->vel_y, em->vel_y, n * sizeof(float));
+    memcpy(snap->entities, em->entities, n * sizeof(Entity));
+    memcpy(snap->ai, em->ai, n * sizeof(AIComponent));
+
+    size_t slots = em->handles.slot_capacity;
+    snap->handles = em->handles;
+    snap->handles.dense = malloc(slots * sizeof(uint32_t));
+    snap->handles.generation = malloc(slots * sizeof(uint16_t));
+    memcpy(snap->handles.dense, em->handles.dense, slots * sizeof(uint32_t));
+    memcpy(snap->handles.generation, em->handles.generation, slots * sizeof(uint16_t));
+
+    projectile_pool_init(&snap->projectiles, game->projectiles.capacity);
+    pool_copy(&snap->projectiles, &game->projectiles);
+}
+
+static void snapshot_restore(const WorldSnapshot* snap, GameState* game) {
+    EntityManager* em = &game->entity_manager;
+    size_t n = snap->count;
+    memcpy(em->pos_x, snap->pos_x, n * sizeof(float));
+    memcpy(em->pos_y, snap->pos_y, n * sizeof(float));
+    memcpy(em->vel_x, snap->vel_x, n * sizeof(float));
+    memcpy(em->vel_y, snap->vel_y, n * sizeof(float));
+    memcpy(em->entities, snap->entities, n * sizeof(Entity));
+    memcpy(em->ai, snap->ai, n * sizeof(AIComponent));
+    em->count = n;
+
+    // Restore sparse index without swapping out the manager's own buffers
+    uint32_t* dense = em->handles.dense;
+    uint16_t* generation = em->handles.generation;
+    size_t slots = snap->handles.slot_capacity;
+    memcpy(dense, snap->handles.dense, slots * sizeof(uint32_t));
+    memcpy(generation, snap->handles.generation, slots * sizeof(uint16_t));
+    em->handles = snap->handles;
+    em->handles.dense = dense;
+    em->handles.generation = generation;
+
+    pool_copy(&game->projectiles, &snap->projectiles);
+}
+
+static void snapshot_free(WorldSnapshot* snap) {
+    free(snap->pos_x);
+    free(snap->pos_y);
+    free(snap->vel_x);
+    free(snap->vel_y);
+    free(snap->entities);
+    free(snap->ai);
+    handle_table_free(&snap->handles);
+    projectile_pool_free(&snap->projectiles);
+}
+
+typedef void (*ResolveFn)(GameState* game);
+
+static void resolve_broadphase(GameState* game) {
+    collision_resolve_all(game);
+    entity_apply_commands(&game->entity_manager);
+    projectile_pool_compact(&game->projectiles);
+}
+
+// Run one resolver 'iterations' times from the same starting world
+static double time_resolver(GameState* game, const WorldSnapshot* snapshot,
+                            ResolveFn resolve, int iterations, long* checksum) {
+    double total = 0.0;
+
+    for (int it = 0; it < iterations; it++) {
+        snapshot_restore(snapshot, game);
+
+        double start = now_seconds();
+        resolve(game);
+        total += now_seconds() - start;
+    }
+
+    *checksum = world_checksum(game);
+    return total / iterations;
+}
+
+static void run_case(int entity_count) {
+    GameState game;
+    memset(&game, 0, sizeof(game));
+    entity_manager_init(&game.entity_manager, (size_t)entity_count);
+    projectile_pool_init(&game.projectiles, (size_t)entity_count / 10 + 1);
+    spatial_hash_init(&game.broadphase, 256);
+
+    populate(&game, entity_count);
+
+    WorldSnapshot snapshot;
+    snapshot_take(&snapshot, &game);
+
+    // Keep total work per case roughly constant
+    int iterations = 2000000 / entity_count;
+    if (iterations > 2000) iterations = 2000;
+    if (iterations < 5) iterations = 5;
+
+    long naive_sum, hash_sum;
+    double naive = time_resolver(&game, &snapshot, collision_resolve_naive, iterations, &naive_sum);
+    double hashed = time_resolver(&game, &snapshot, resolve_broadphase, iterations, &hash_sum);
+
+    fprintf(stderr, "%6d entities | nested loop %10.1f us | spatial hash %8.1f us | %6.1fx %s\n",
+            entity_count, naive * 1e6, hashed * 1e6, naive / hashed,
+            naive_sum == hash_sum ? "" : "(MISMATCH!)");
+
+    snapshot_free(&snapshot);
+    spatial_hash_free(&game.broadphase);
+    projectile_pool_free(&game.projectiles);
+    entity_manager_free(&game.entity_manager);
+}
+
+int main() {
+    // Game code prints on every create/hit; keep that out of the timings' output
+    freopen(NULL_DEVICE, "w", stdout);
+
+    fprintf(stderr, "=== COLLISION BENCHMARK (collision_resolve_all per tick) ===\n");
+
+    int sizes[] = {100, 1000, 10000};
+    for (int i = 0; i < 3; i++) {
+        run_case(sizes[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/flow_field.h"
+#include "../src/rng.h"
+#include "../src/protocol.h"
+#include "../src/timing.h"
+
+#ifdef _WIN32
+    #define NULL_DEVICE "NUL"
+#else
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+// Flow field cost against dungeon size: a full rebuild (BFS over the map
+// toward a random floor tile, what a player stepping into a new tile
+// costs) and one steering lookup (what every chasing enemy pays per tick).
+
+#define SEED 1234
+#define REBUILDS 200
+#define LOOKUPS 1000000
+
+static void bench_size(int width, int height) {
+    Dungeon dungeon;
+    dungeon_generate(&dungeon, SEED, width, height, MAP_MIN_X, MAP_MIN_Y);
+    FlowFieldSet set;
+    flow_field_init(&set, &dungeon);
+
+    FlowField field;
+    field.player_id = 1;
+    field.next = malloc((size_t)set.width * (size_t)set.height);
+    if (field.next == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    Rng rng;
+    rng_seed(&rng, SEED, (uint64_t)width);
+    uint64_t build_ns = 0;
+    for (int i = 0; i < REBUILDS; i++) {
+        Vector2 goal = dungeon_random_spawn(&dungeon, &rng);
+        int tx = dungeon_tile_x(&dungeon, goal.x);
+        int ty = dungeon_tile_y(&dungeon, goal.y);
+        uint64_t start = timing_now_ns();
+        flow_field_build(&set, &field, tx, ty);
+        build_ns += timing_now_ns() - start;
+    }
+
+    // Lookups from random floor positions (the last field stays built)
+    float* xs = malloc(LOOKUPS * sizeof(float));
+    float* ys = malloc(LOOKUPS * sizeof(float));
+    if (xs == NULL || ys == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    for (int i = 0; i < LOOKUPS; i++) {
+        Vector2 corner = dungeon_random_spawn(&dungeon, &rng);
+        xs[i] = corner.x + rng_range(&rng, 0.0f, (float)DUNGEON_TILE_SIZE);
+        ys[i] = corner.y + rng_range(&rng, 0.0f, (float)DUNGEON_TILE_SIZE);
+    }
+    int steered = 0;
+    uint64_t start = timing_now_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        Vector2 direction;
+        steered += flow_field_direction(&set, &field, xs[i], ys[i], &direction);
+    }
+    uint64_t lookup_ns = timing_now_ns() - start;
+
+    int floor = dungeon_floor_count(&dungeon);
+    double per_build = (double)build_ns / REBUILDS;
+    fprintf(stderr, "%4dx%-4d %7d floor | rebuild %9.1f us  %5.2f ns/floor tile | lookup %5.2f ns (%d%% steered)\n",
+            width, height, floor, per_build / 1000.0, per_build / (double)floor,
+            (double)lookup_ns / LOOKUPS, (int)(100.0 * steered / LOOKUPS));
+
+    free(xs);
+    free(ys);
+    free(field.next);
+    flow_field_free(&set);
+    dungeon_free(&dungeon);
+}
+
+int main(void) {
+    // Dungeon setup may log to stdout; results go to stderr
+    freopen(NULL_DEVICE, "w", stdout);
+    fprintf(stderr, "=== FLOW FIELD BENCHMARK (%d rebuilds, %d lookups per size) ===\n",
+            REBUILDS, LOOKUPS);
+
+    int sizes[][2] = {{25, 18}, {DUNGEON_WIDTH, DUNGEON_HEIGHT}, {100, 75}, {200, 150}, {400, 300}};
+    for (int s = 0; s < 5; s++) {
+        bench_size(sizes[s][0], sizes[s][1]);
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/protocol.h"
+#include "../src/timing.h"
+
+// Bytes and nanoseconds per entity for STATE encoding and decoding, for a
+// full state (every entity new) and a typical delta (everything moved and
+// turned a little). Sizes are compared against the earlier byte-aligned
+// layouts: the original fixed 22-byte entity and the first delta format
+// (id + flags byte + raw floats/int16s).
+
+#define ENTITIES 1000
+#define ITERATIONS 2000
+
+#define LEGACY_FULL_BYTES 22         // id(4) type(1) pos(8) hp(2) maxhp(2) rot(4) active(1)
+#define LEGACY_DELTA_MOVE_BYTES 17   // id(4) flags(1) pos(8) rot(4)
+
+static EntityState base_entities[ENTITIES];
+static EntityState moved_entities[ENTITIES];
+static EntityState decoded_entities[ENTITIES];
+static uint8_t buffer[ENTITIES * 16 + 64];
+
+static float random_range(float min, float max) {
+    return min + (float)rand() / (float)RAND_MAX * (max - min);
+}
+
+static void fill_world(void) {
+    for (int i = 0; i < ENTITIES; i++) {
+        EntityState* e = &base_entities[i];
+        e->entity_id = (uint32_t)(i * 3 + 1);   // Sorted, with gaps from despawns
+        e->entity_type = (uint8_t)(rand() % 3);
+        e->x = random_range(MAP_MIN_X, MAP_MAX_X);
+        e->y = random_range(MAP_MIN_Y, MAP_MAX_Y);
+        e->max_health = (e->entity_type == 2) ? 1 : 100;
+        e->health = (int16_t)(rand() % (e->max_health + 1));
+        e->rotation = random_range(-3.14159f, 3.14159f);
+        e->active = true;
+
+        // One tick later: moved up to ~4 px and turned slightly
+        moved_entities[i] = *e;
+        moved_entities[i].x += random_range(-4.0f, 4.0f);
+        moved_entities[i].y += random_range(-4.0f, 4.0f);
+        moved_entities[i].rotation += random_range(-0.1f, 0.1f);
+    }
+}
+
+static void run_case(const char* name, const StateMessage* baseline, const StateMessage* current,
+                     int legacy_bytes) {
+    int size = serialize_state(baseline, current, buffer, sizeof(buffer));
+    if (size < 0) {
+        fprintf(stderr, "%s: encode failed\n", name);
+        exit(1);
+    }
+
+    uint64_t t0 = timing_now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        serialize_state(baseline, current, buffer, sizeof(buffer));
+    }
+    uint64_t t1 = timing_now_ns();
+
+    StateMessage decoded = {.entity_capacity = ENTITIES, .entities = decoded_entities};
+    for (int i = 0; i < ITERATIONS; i++) {
+        if (deserialize_state(buffer, size, baseline, &decoded) != size) {
+            fprintf(stderr, "%s: decode failed\n", name);
+            exit(1);
+        }
+    }
+    uint64_t t2 = timing_now_ns();
+
+    double entity_count = (double)ENTITIES * ITERATIONS;
+    double bytes = (double)(size - STATE_HEADER_SIZE - 4) / ENTITIES;
+    fprintf(stderr, "%-12s | %5.2f bytes/entity (was %d, %.0f%% smaller) | encode %6.1f ns/entity | decode %6.1f ns/entity\n",
+            name, bytes, legacy_bytes, 100.0 * (1.0 - bytes / legacy_bytes),
+            (double)(t1 - t0) / entity_count, (double)(t2 - t1) / entity_count);
+}
+
+int main() {
+    srand(1234);
+    fill_world();
+
+    fprintf(stderr, "=== STATE ENCODING BENCHMARK (%d entities x %d iterations) ===\n",
+            ENTITIES, ITERATIONS);
+
+    StateMessage base = {.tick = 100, .entity_count = ENTITIES, .entities = base_entities};
+    StateMessage moved = {.tick = 101, .entity_count = ENTITIES, .entities = moved_entities};
+
+    // The decoder's baseline is what the client holds: the quantized values
+    static EntityState client_entities[ENTITIES];
+    StateMessage client_base = {.entity_capacity = ENTITIES, .entities = client_entities};
+    int size = serialize_state(NULL, &base, buffer, sizeof(buffer));
+    deserialize_state(buffer, size, NULL, &client_base);
+
+    run_case("full state", NULL, &base, LEGACY_FULL_BYTES);
+    run_case("delta (move)", &client_base, &moved, LEGACY_DELTA_MOVE_BYTES);
+
+    return 0;
+}
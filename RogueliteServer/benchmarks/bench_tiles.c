@@ -0,0 +1,198 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../src/tile_collision.h"
+#include "../src/rng.h"
+#include "../src/protocol.h"
+#include "../src/timing.h"
+
+#ifdef _WIN32
+    #define NULL_DEVICE "NUL"
+#else
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+// Wall collision cost per entity per tick on a generated dungeon:
+// swept AABB movement (tile_collision_move_entities) against the plain
+// integrate it replaces (entity_update_all), then DDA projectile tracing
+// at falling tick rates, counting the wall hits an end-point-only check
+// would have tunnelled through. First checks that boxes drifted a hair
+// over a wall edge still move; exits 1 if any stick.
+
+#define TICKS 600
+#define SEED 1234
+#define ENEMY_SPEED 100.0f
+#define PROJECTILE_SPEED 300.0f     // As fired in network_apply_inputs
+
+#define DRIFT 0.005f                // Sideways float drift over a wall edge (under the skin)
+#define DRIFT_TICKS 10              // 13 px at ENEMY_SPEED: never reaches the next tile
+
+// A box aligned with floor tile (tx, ty), drifted DRIFT toward 'side' (-1
+// or 1 on the other axis), moving one tile step (step_x, step_y) into
+// open floor that has a wall beside it on that side. Returns false if it
+// can't move away.
+static bool drift_moves(const Dungeon* dungeon, int tx, int ty, int step_x, int step_y, int side) {
+    int side_x = step_x == 0 ? side : 0;
+    int side_y = step_y == 0 ? side : 0;
+
+    EntityManager em;
+    entity_manager_init(&em, 1);
+    float start_x = dungeon->origin_x + (float)(tx * DUNGEON_TILE_SIZE) + (float)side_x * DRIFT;
+    float start_y = dungeon->origin_y + (float)(ty * DUNGEON_TILE_SIZE) + (float)side_y * DRIFT;
+    entity_create(&em, ENTITY_TYPE_ENEMY, vector2_create(start_x, start_y));
+    for (int tick = 0; tick < DRIFT_TICKS; tick++) {
+        em.vel_x[0] = (float)step_x * ENEMY_SPEED;
+        em.vel_y[0] = (float)step_y * ENEMY_SPEED;
+        tile_collision_move_entities(&em, dungeon, 1.0f / 60.0f);
+    }
+    float moved = fabsf(em.pos_x[0] - start_x) + fabsf(em.pos_y[0] - start_y);
+    entity_manager_free(&em);
+    return moved > 10.0f;
+}
+
+// Every floor tile, moving each way, drifted to each side: returns failures
+static int check_drift(const Dungeon* dungeon, int* cases) {
+    static const int steps[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    int failures = 0;
+    *cases = 0;
+    for (int ty = 0; ty < dungeon->height; ty++) {
+        for (int tx = 0; tx < dungeon->width; tx++) {
+            if (!dungeon_tile_walkable(dungeon, tx, ty)) continue;
+            for (int s = 0; s < 4; s++) {
+                for (int side = -1; side <= 1; side += 2) {
+                    int sx = steps[s][0], sy = steps[s][1];
+                    bool edge = dungeon_tile_walkable(dungeon, tx + sx, ty + sy) &&
+                                !dungeon_tile_walkable(dungeon, tx + sx + (sx == 0 ? side : 0),
+                                                       ty + sy + (sy == 0 ? side : 0));
+                    if (!edge) continue;
+                    (*cases)++;
+                    if (!drift_moves(dungeon, tx, ty, sx, sy, side)) failures++;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+static double per_entity(uint64_t ns, size_t count) {
+    return (double)ns / ((double)count * TICKS);
+}
+
+// Enemies on open floor, each walking a random direction that changes every second
+static void populate(EntityManager* em, const Dungeon* dungeon, Rng* rng, int count) {
+    for (int i = 0; i < count; i++) {
+        entity_create(em, ENTITY_TYPE_ENEMY, dungeon_random_spawn(dungeon, rng));
+    }
+}
+
+static void steer(EntityManager* em, Rng* rng, int tick) {
+    for (size_t i = 0; i < em->count; i++) {
+        if ((tick + (int)i) % 60 != 0) continue;
+        float angle = rng_range(rng, 0.0f, 6.2831853f);
+        em->vel_x[i] = cosf(angle) * ENEMY_SPEED;
+        em->vel_y[i] = sinf(angle) * ENEMY_SPEED;
+    }
+}
+
+static void bench_movement(const Dungeon* dungeon, int count) {
+    float dt = 1.0f / 60.0f;
+    uint64_t ns[2] = {0, 0};
+
+    for (int pass = 0; pass < 2; pass++) {
+        EntityManager em;
+        Rng rng;
+        rng_seed(&rng, SEED, 0);
+        entity_manager_init(&em, (size_t)count);
+        populate(&em, dungeon, &rng, count);
+
+        for (int tick = 0; tick < TICKS; tick++) {
+            steer(&em, &rng, tick);
+            uint64_t start = timing_now_ns();
+            if (pass == 0) {
+                entity_update_all(&em, dt);
+            } else {
+                tile_collision_move_entities(&em, dungeon, dt);
+            }
+            ns[pass] += timing_now_ns() - start;
+        }
+        entity_manager_free(&em);
+    }
+
+    fprintf(stderr, "%6d entities | integrate %6.2f ns | swept tiles %6.2f ns/entity/tick\n",
+            count, per_entity(ns[0], (size_t)count), per_entity(ns[1], (size_t)count));
+}
+
+// Projectiles respawned on open floor every tick, fired in random directions
+static void bench_projectiles(const Dungeon* dungeon, int count, int tick_rate) {
+    float dt = 1.0f / (float)tick_rate;
+    ProjectilePool pool;
+    Rng rng;
+    rng_seed(&rng, SEED, (uint64_t)tick_rate);
+    projectile_pool_init(&pool, (size_t)count);
+
+    uint64_t ns = 0;
+    uint64_t hits = 0;
+    uint64_t tunnelled = 0;
+    for (int tick = 0; tick < TICKS; tick++) {
+        while (pool.count < pool.capacity) {
+            Vector2 corner = dungeon_random_spawn(dungeon, &rng);
+            float angle = rng_range(&rng, 0.0f, 6.2831853f);
+            projectile_spawn(&pool, vector2_create(corner.x + 12.0f, corner.y + 12.0f),
+                             vector2_create(cosf(angle) * PROJECTILE_SPEED,
+                                            sinf(angle) * PROJECTILE_SPEED), 0, angle);
+        }
+
+        uint64_t start = timing_now_ns();
+        tile_collision_projectiles(&pool, dungeon, dt);
+        ns += timing_now_ns() - start;
+
+        for (size_t i = 0; i < pool.count; i++) {
+            if (pool.active[i]) continue;
+            hits++;
+            float x = pool.pos_x[i] + PROJECTILE_SIZE * 0.5f + pool.vel_x[i] * dt;
+            float y = pool.pos_y[i] + PROJECTILE_SIZE * 0.5f + pool.vel_y[i] * dt;
+            if (dungeon_walkable_at(dungeon, x, y)) tunnelled++;
+        }
+        projectile_pool_update(&pool, dt, MAP_MIN_X, MAP_MIN_Y, MAP_MAX_X, MAP_MAX_Y);
+        projectile_pool_compact(&pool);
+    }
+
+    fprintf(stderr, "%6d projectiles | %2d Hz | DDA %6.2f ns/projectile/tick | "
+            "%5.1f%% of wall hits would tunnel end-point only\n",
+            count, tick_rate, per_entity(ns, (size_t)count),
+            hits > 0 ? 100.0 * (double)tunnelled / (double)hits : 0.0);
+    projectile_pool_free(&pool);
+}
+
+int main(void) {
+    // Manager and pool setup log to stdout; results go to stderr
+    freopen(NULL_DEVICE, "w", stdout);
+
+    Dungeon dungeon;
+    dungeon_generate(&dungeon, SEED, DUNGEON_WIDTH, DUNGEON_HEIGHT, MAP_MIN_X, MAP_MIN_Y);
+    fprintf(stderr, "=== TILE COLLISION BENCHMARK (%dx%d dungeon, %d floor tiles, %d ticks) ===\n",
+            dungeon.width, dungeon.height, dungeon_floor_count(&dungeon), TICKS);
+
+    int cases;
+    int stuck = check_drift(&dungeon, &cases);
+    fprintf(stderr, "Drift check: %d of %d boxes drifted %.3f px over a wall edge stuck\n",
+            stuck, cases, DRIFT);
+    if (stuck > 0) {
+        dungeon_free(&dungeon);
+        return 1;
+    }
+
+    int sizes[] = {100, 1000, 10000};
+    for (int s = 0; s < 3; s++) {
+        bench_movement(&dungeon, sizes[s]);
+    }
+
+    int rates[] = {60, 20, 10, 5};
+    for (int r = 0; r < 4; r++) {
+        bench_projectiles(&dungeon, 1000, rates[r]);
+    }
+
+    dungeon_free(&dungeon);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/udp_batch.h"
+#include "../src/timing.h"
+
+#ifdef _WIN32
+    #define closesocket_portable closesocket
+#else
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #define closesocket_portable close
+#endif
+
+// Packets/second through localhost UDP for the one-syscall-per-datagram
+// path (recvfrom/sendto) and the batched path (recvmmsg/sendmmsg).
+// Each round sends one full batch, then drains it on the receiver, so the
+// socket buffer never overflows and both directions are timed separately.
+
+#define BATCH 64
+#define ROUNDS 5000
+#define PAYLOAD_SIZE 200   // Roughly one state snapshot
+
+static SOCKET open_socket(struct sockaddr_in* bound) {
+    SOCKET sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock == INVALID_SOCKET) {
+        fprintf(stderr, "socket() failed\n");
+        exit(1);
+    }
+    
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;  // Any free port
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "bind() failed\n");
+        exit(1);
+    }
+    
+    socklen_t len = sizeof(*bound);
+    getsockname(sock, (struct sockaddr*)bound, &len);
+    
+    int rcvbuf = 4 * 1024 * 1024;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char*)&rcvbuf, sizeof(rcvbuf));
+    
+#ifdef _WIN32
+    u_long mode = 1;
+    ioctlsocket(sock, FIONBIO, &mode);
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+#endif
+    return sock;
+}
+
+static void run_case(const char* name, bool use_mmsg) {
+    struct sockaddr_in receiver_addr, sender_addr;
+    SOCKET receiver = open_socket(&receiver_addr);
+    SOCKET sender = open_socket(&sender_addr);
+    
+    UdpBatch send_batch, recv_batch;
+    udp_batch_init(&send_batch, BATCH, 0);
+    udp_batch_init(&recv_batch, BATCH, 1024);
+    send_batch.use_mmsg = use_mmsg;
+    recv_batch.use_mmsg = use_mmsg;
+    
+    uint8_t payload[PAYLOAD_SIZE];
+    memset(payload, 0xAB, sizeof(payload));
+    
+    uint64_t send_ns = 0, recv_ns = 0;
+    uint64_t sent = 0, received = 0;
+    
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < BATCH; i++) {
+            UdpPacket* packet = &send_batch.packets[i];
+            packet->data = payload;
+            packet->length = PAYLOAD_SIZE;
+            packet->addr = receiver_addr;
+        }
+        send_batch.count = BATCH;
+        
+        uint64_t t0 = timing_now_ns();
+        sent += (uint64_t)udp_send_batch(sender, &send_batch);
+        uint64_t t1 = timing_now_ns();
+        
+        // Loopback delivery is synchronous, so everything sent is already queued
+        int got = 0;
+        while (got < BATCH) {
+            int n = udp_recv_batch(receiver, &recv_batch);
+            if (n == 0) break;
+            got += n;
+        }
+        uint64_t t2 = timing_now_ns();
+        
+        received += (uint64_t)got;
+        send_ns += t1 - t0;
+        recv_ns += t2 - t1;
+    }
+    
+    fprintf(stderr, "%-22s | send %9.0f pkt/s (%.2f syscalls/pkt) | recv %9.0f pkt/s (%.2f syscalls/pkt) | lost %llu\n",
+            name,
+            sent / (send_ns / 1e9), (double)send_batch.syscalls / (double)sent,
+            received / (recv_ns / 1e9), (double)recv_batch.syscalls / (double)received,
+            (unsigned long long)(sent - received));
+    
+    udp_batch_free(&send_batch);
+    udp_batch_free(&recv_batch);
+    closesocket_portable(sender);
+    closesocket_portable(receiver);
+}
+
+int main() {
+#ifdef _WIN32
+    WSADATA wsa;
+    WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+    
+    fprintf(stderr, "=== UDP BATCH BENCHMARK (%d x %d datagrams of %d bytes, localhost) ===\n",
+            ROUNDS, BATCH, PAYLOAD_SIZE);
+    
+    run_case("recvfrom/sendto", false);
+#if UDP_HAVE_MMSG
+    run_case("recvmmsg/sendmmsg", true);
+#else
+    fprintf(stderr, "recvmmsg/sendmmsg not available on this platform\n");
+#endif
+    
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return 0;
+}
@@ -0,0 +1,408 @@
+#define _DEFAULT_SOURCE  // clock_gettime / random() under -std=c11
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#ifdef __linux__
+    #include <sys/epoll.h>
+#else
+    #include <poll.h>
+#endif
+
+#include "../src/protocol.h"
+
+// Headless load generator: N simulated clients in one process, one
+// non-blocking socket each, multiplexed with epoll (poll elsewhere).
+// Every bot connects, sends INPUT at the input rate (moving and shooting,
+// scripted or random), ACKs each complete STATE tick so the server's
+// delta path is exercised, and records bytes received and the
+// inter-arrival time of STATE ticks. A summary is printed at the end.
+//
+// Usage: bot_swarm [--bots N] [--seconds S] [--port P] [--host IP]
+//                  [--input-rate HZ] [--tick-rate HZ] [--mode scripted|random]
+
+#define DEFAULT_BOTS 50
+#define DEFAULT_SECONDS 10
+#define DEFAULT_PORT 12345
+#define DEFAULT_RATE 60
+#define CONNECT_RETRY_NS 1000000000ull
+
+// Inter-arrival histogram: 50 us buckets up to 250 ms (the rest in the last one)
+#define ARRIVAL_BUCKET_NS 50000ull
+#define ARRIVAL_BUCKETS 5000
+
+#define NS_PER_SECOND 1000000000ull
+
+typedef struct {
+    int sock;
+    int index;
+    uint32_t player_id;         // 0 until WELCOME
+    uint64_t connect_sent_ns;
+    uint64_t welcome_ns;
+
+    // STATE tick being assembled (only the newest one is tracked)
+    uint32_t tick;
+    uint32_t fragments_received;
+    int fragment_count;         // Known once the last fragment arrives
+    bool tick_complete;
+    uint64_t last_arrival_ns;   // First fragment of the previous tick
+
+    // Script / random input state
+    uint8_t keys;
+    float aim_angle;
+    uint64_t next_change_ns;
+
+    // Results
+    uint64_t bytes_sent;
+    uint64_t bytes_received;
+    uint64_t packets_received;
+    uint64_t inputs_sent;
+    uint64_t acks_sent;
+    uint64_t ticks_seen;
+    uint64_t ticks_complete;
+} Bot;
+
+typedef struct {
+    int bots;
+    int seconds;
+    int port;
+    const char* host;
+    int input_rate;
+    int tick_rate;
+    bool random_mode;
+} SwarmConfig;
+
+static uint32_t arrival_counts[ARRIVAL_BUCKETS];
+static uint64_t arrival_total;
+static uint64_t arrival_max_ns;
+static double arrival_sum_ns;
+static double arrival_sum_sq_ns;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SECOND + (uint64_t)ts.tv_nsec;
+}
+
+static void record_arrival(uint64_t interval_ns) {
+    uint64_t bucket = interval_ns / ARRIVAL_BUCKET_NS;
+    if (bucket >= ARRIVAL_BUCKETS) bucket = ARRIVAL_BUCKETS - 1;
+    arrival_counts[bucket]++;
+    arrival_total++;
+    if (interval_ns > arrival_max_ns) arrival_max_ns = interval_ns;
+    arrival_sum_ns += (double)interval_ns;
+    arrival_sum_sq_ns += (double)interval_ns * (double)interval_ns;
+}
+
+// Upper edge of the bucket holding the given percentile, in ms
+static double arrival_percentile_ms(double percentile) {
+    uint64_t rank = (uint64_t)ceil(percentile / 100.0 * (double)arrival_total);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < ARRIVAL_BUCKETS; i++) {
+        seen += arrival_counts[i];
+        if (seen >= rank) return (double)((uint64_t)(i + 1) * ARRIVAL_BUCKET_NS) / 1e6;
+    }
+    return (double)arrival_max_ns / 1e6;
+}
+
+static void bot_send(Bot* bot, const uint8_t* buffer, int size) {
+    if (send(bot->sock, buffer, (size_t)size, 0) == size) {
+        bot->bytes_sent += (uint64_t)size;
+    }
+}
+
+static void bot_send_connect(Bot* bot, uint64_t now) {
+    ConnectMessage msg;
+    snprintf(msg.player_name, sizeof(msg.player_name), "Bot%d", bot->index);
+    uint8_t buffer[64];
+    int size = serialize_connect(&msg, buffer, sizeof(buffer));
+    bot_send(bot, buffer, size);
+    bot->connect_sent_ns = now;
+}
+
+// Scripted: walk a square (one side per second, phase by bot index) while
+// sweeping the aim around the map center. Random: new keys and aim every
+// 0.25-1 s. Both hold the fire key most of the time (the server's cooldown
+// caps shots at 5/s).
+static void bot_update_input(Bot* bot, const SwarmConfig* config, uint64_t now) {
+    if (config->random_mode) {
+        if (now >= bot->next_change_ns) {
+            static const uint8_t moves[] = {0, KEY_W, KEY_A, KEY_S, KEY_D,
+                                            KEY_W | KEY_A, KEY_W | KEY_D, KEY_S | KEY_A, KEY_S | KEY_D};
+            bot->keys = moves[random() % (long)sizeof(moves)];
+            if (random() % 10 < 7) bot->keys |= KEY_SPACE;
+            bot->aim_angle = (float)(random() % 6283) / 1000.0f;
+            bot->next_change_ns = now + 250000000ull + (uint64_t)(random() % 750) * 1000000ull;
+        }
+    } else {
+        static const uint8_t sides[] = {KEY_W, KEY_D, KEY_S, KEY_A};
+        uint64_t second = now / NS_PER_SECOND + (uint64_t)bot->index;
+        bot->keys = sides[second % 4] | KEY_SPACE;
+        bot->aim_angle += 0.05f;
+    }
+}
+
+static void bot_send_input(Bot* bot, uint64_t now, const SwarmConfig* config) {
+    bot_update_input(bot, config, now);
+
+    InputMessage input;
+    input.player_id = bot->player_id;
+    input.keys = bot->keys;
+    input.mouse_x = 400.0f + cosf(bot->aim_angle) * 300.0f;   // Around the map center
+    input.mouse_y = 300.0f + sinf(bot->aim_angle) * 300.0f;
+
+    uint8_t buffer[32];
+    int size = serialize_input(&input, buffer, sizeof(buffer));
+    bot_send(bot, buffer, size);
+    bot->inputs_sent++;
+}
+
+static void bot_handle_state(Bot* bot, const uint8_t* buffer, int length, uint64_t now) {
+    uint32_t tick;
+    uint8_t fragment;
+    bool last;
+    if (!state_peek_fragment(buffer, length, &tick, &fragment, &last) ||
+        fragment >= STATE_MAX_FRAGMENTS) return;
+
+    if (tick < bot->tick) return;  // Late fragment of an older tick
+    if (tick > bot->tick) {
+        // New tick: its first fragment marks the arrival
+        if (bot->last_arrival_ns != 0) record_arrival(now - bot->last_arrival_ns);
+        bot->last_arrival_ns = now;
+        bot->tick = tick;
+        bot->fragments_received = 0;
+        bot->fragment_count = 0;
+        bot->tick_complete = false;
+        bot->ticks_seen++;
+    }
+
+    bot->fragments_received |= 1u << fragment;
+    if (last) bot->fragment_count = fragment + 1;
+    if (bot->tick_complete || bot->fragment_count == 0 ||
+        bot->fragments_received != (uint32_t)((1ull << bot->fragment_count) - 1)) return;
+
+    // Whole tick in: ACK it so the next states are deltas against it
+    bot->tick_complete = true;
+    bot->ticks_complete++;
+    uint8_t ack[8];
+    int size = serialize_ack(tick, ack, sizeof(ack));
+    bot_send(bot, ack, size);
+    bot->acks_sent++;
+}
+
+static void bot_receive(Bot* bot, uint64_t now) {
+    uint8_t buffer[MAX_PACKET_SIZE];
+    while (1) {
+        ssize_t length = recv(bot->sock, buffer, sizeof(buffer), 0);
+        if (length <= 0) return;  // EAGAIN: drained
+
+        bot->packets_received++;
+        bot->bytes_received += (uint64_t)length;
+
+        if (buffer[0] == MSG_WELCOME && length >= 5 && bot->player_id == 0) {
+            bot->player_id = ((uint32_t)buffer[1] << 24) | ((uint32_t)buffer[2] << 16) |
+                             ((uint32_t)buffer[3] << 8) | buffer[4];
+            bot->welcome_ns = now;
+        } else if (buffer[0] == MSG_STATE) {
+            bot_handle_state(bot, buffer, (int)length, now);
+        }
+    }
+}
+
+static bool parse_args(SwarmConfig* config, int argc, char** argv) {
+    config->bots = DEFAULT_BOTS;
+    config->seconds = DEFAULT_SECONDS;
+    config->port = DEFAULT_PORT;
+    config->host = "127.0.0.1";
+    config->input_rate = DEFAULT_RATE;
+    config->tick_rate = DEFAULT_RATE;
+    config->random_mode = false;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* value = argv[i + 1];
+        if (strcmp(arg, "--bots") == 0) config->bots = atoi(value);
+        else if (strcmp(arg, "--seconds") == 0) config->seconds = atoi(value);
+        else if (strcmp(arg, "--port") == 0) config->port = atoi(value);
+        else if (strcmp(arg, "--host") == 0) config->host = value;
+        else if (strcmp(arg, "--input-rate") == 0) config->input_rate = atoi(value);
+        else if (strcmp(arg, "--tick-rate") == 0) config->tick_rate = atoi(value);
+        else if (strcmp(arg, "--mode") == 0) config->random_mode = strcmp(value, "random") == 0;
+        else return false;
+    }
+    if (argc % 2 == 0) return false;  // Option without a value
+    return config->bots > 0 && config->seconds > 0 && config->input_rate > 0 && config->tick_rate > 0;
+}
+
+static void print_summary(const Bot* bots, const SwarmConfig* config, double elapsed) {
+    int connected = 0;
+    uint64_t welcome_max = 0, welcome_sum = 0;
+    uint64_t bytes = 0, bytes_sent = 0, packets = 0, inputs = 0, acks = 0, seen = 0, complete = 0;
+    uint64_t bytes_min = UINT64_MAX, bytes_max = 0;
+
+    for (int i = 0; i < config->bots; i++) {
+        const Bot* bot = &bots[i];
+        if (bot->player_id == 0) continue;  // Never got in (server full?): per-bot figures skip it
+        connected++;
+        uint64_t latency = bot->welcome_ns - bot->connect_sent_ns;
+        welcome_sum += latency;
+        if (latency > welcome_max) welcome_max = latency;
+        bytes += bot->bytes_received;
+        bytes_sent += bot->bytes_sent;
+        packets += bot->packets_received;
+        inputs += bot->inputs_sent;
+        acks += bot->acks_sent;
+        seen += bot->ticks_seen;
+        complete += bot->ticks_complete;
+        if (bot->bytes_received < bytes_min) bytes_min = bot->bytes_received;
+        if (bot->bytes_received > bytes_max) bytes_max = bot->bytes_received;
+    }
+
+    double per_bot = elapsed * (double)(connected > 0 ? connected : 1);
+    if (connected == 0) bytes_min = 0;
+    printf("\n=== BOT SWARM SUMMARY (%d bots, %s input, %.1f s) ===\n",
+           config->bots, config->random_mode ? "random" : "scripted", elapsed);
+    printf("Connected:     %d/%d (WELCOME after avg %.2f ms, max %.2f ms)\n", connected, config->bots,
+           connected ? (double)welcome_sum / connected / 1e6 : 0.0, (double)welcome_max / 1e6);
+    printf("Sent:          %llu inputs (%.1f/s per bot), %llu ACKs, %.1f KB/s total\n",
+           (unsigned long long)inputs, (double)inputs / per_bot, (unsigned long long)acks,
+           (double)bytes_sent / elapsed / 1024.0);
+    printf("Received:      %llu packets, %.1f KB/s total, %.2f KB/s per bot (min %.2f, max %.2f)\n",
+           (unsigned long long)packets, (double)bytes / elapsed / 1024.0,
+           (double)bytes / per_bot / 1024.0,
+           (double)bytes_min / elapsed / 1024.0, (double)bytes_max / elapsed / 1024.0);
+    printf("STATE ticks:   %.1f/s per bot (%d Hz expected), %llu of %llu complete (%.2f%%)\n",
+           (double)seen / per_bot, config->tick_rate, (unsigned long long)complete,
+           (unsigned long long)seen, seen ? 100.0 * (double)complete / (double)seen : 0.0);
+
+    if (arrival_total > 0) {
+        double mean = arrival_sum_ns / (double)arrival_total;
+        double variance = arrival_sum_sq_ns / (double)arrival_total - mean * mean;
+        printf("Inter-arrival: mean %.2f ms (expected %.2f), jitter (stddev) %.2f ms, "
+               "p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+               mean / 1e6, 1000.0 / config->tick_rate, sqrt(variance > 0.0 ? variance : 0.0) / 1e6,
+               arrival_percentile_ms(50.0), arrival_percentile_ms(99.0), (double)arrival_max_ns / 1e6);
+    }
+}
+
+int main(int argc, char** argv) {
+    SwarmConfig config;
+    if (!parse_args(&config, argc, argv)) {
+        printf("Usage: %s [--bots N] [--seconds S] [--port P] [--host IP] "
+               "[--input-rate HZ] [--tick-rate HZ] [--mode scripted|random]\n", argv[0]);
+        return 1;
+    }
+    srandom((unsigned int)time(NULL));
+
+    Bot* bots = calloc((size_t)config.bots, sizeof(Bot));
+    if (bots == NULL) {
+        fprintf(stderr, "Failed to allocate bots!\n");
+        return 1;
+    }
+
+    struct sockaddr_in server_addr;
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons((unsigned short)config.port);
+    server_addr.sin_addr.s_addr = inet_addr(config.host);
+
+#ifdef __linux__
+    int epoll_fd = epoll_create1(0);
+    struct epoll_event* events = calloc((size_t)config.bots, sizeof(struct epoll_event));
+#else
+    struct pollfd* pfds = calloc((size_t)config.bots, sizeof(struct pollfd));
+#endif
+
+    // One connected, non-blocking socket per bot (its own source port = its own session)
+    uint64_t start = now_ns();
+    for (int i = 0; i < config.bots; i++) {
+        Bot* bot = &bots[i];
+        bot->index = i;
+        bot->sock = socket(AF_INET, SOCK_DGRAM, 0);
+        if (bot->sock < 0 || connect(bot->sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+            fprintf(stderr, "Bot %d: socket failed (%s)\n", i, strerror(errno));
+            return 1;
+        }
+        fcntl(bot->sock, F_SETFL, fcntl(bot->sock, F_GETFL, 0) | O_NONBLOCK);
+        bot->aim_angle = (float)i;
+
+#ifdef __linux__
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u32 = (uint32_t)i;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, bot->sock, &event);
+#else
+        pfds[i].fd = bot->sock;
+        pfds[i].events = POLLIN;
+#endif
+        bot_send_connect(bot, start);
+    }
+
+    printf("=== BOT SWARM: %d bots -> %s:%d for %d s ===\n",
+           config.bots, config.host, config.port, config.seconds);
+
+    uint64_t input_interval = NS_PER_SECOND / (uint64_t)config.input_rate;
+    uint64_t next_input = start;
+    uint64_t end = start + (uint64_t)config.seconds * NS_PER_SECOND;
+
+    while (1) {
+        uint64_t now = now_ns();
+        if (now >= end) break;
+
+        // Input frame: every welcomed bot sends one; the rest retry CONNECT
+        if (now >= next_input) {
+            for (int i = 0; i < config.bots; i++) {
+                Bot* bot = &bots[i];
+                if (bot->player_id != 0) bot_send_input(bot, now, &config);
+                else if (now - bot->connect_sent_ns >= CONNECT_RETRY_NS) bot_send_connect(bot, now);
+            }
+            next_input += input_interval;
+            if (next_input < now) next_input = now + input_interval;  // Fell behind: don't burst
+        }
+
+        uint64_t wait_ns = next_input > now ? next_input - now : 0;
+        int timeout_ms = (int)((wait_ns + 999999) / 1000000);
+
+#ifdef __linux__
+        int ready = epoll_wait(epoll_fd, events, config.bots, timeout_ms);
+        now = now_ns();
+        for (int i = 0; i < ready; i++) {
+            bot_receive(&bots[events[i].data.u32], now);
+        }
+#else
+        int ready = poll(pfds, (nfds_t)config.bots, timeout_ms);
+        now = now_ns();
+        for (int i = 0; ready > 0 && i < config.bots; i++) {
+            if (pfds[i].revents & POLLIN) bot_receive(&bots[i], now);
+        }
+#endif
+    }
+
+    double elapsed = (double)(now_ns() - start) / 1e9;
+    print_summary(bots, &config, elapsed);
+
+    // Leave cleanly so the server frees the slots right away
+    uint8_t disconnect = MSG_DISCONNECT;
+    for (int i = 0; i < config.bots; i++) {
+        send(bots[i].sock, &disconnect, 1, 0);
+        close(bots[i].sock);
+    }
+
+#ifdef __linux__
+    close(epoll_fd);
+    free(events);
+#else
+    free(pfds);
+#endif
+    free(bots);
+    return 0;
+}
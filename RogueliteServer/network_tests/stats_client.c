@@ -0,0 +1,117 @@
+#ifndef _WIN32
+    #define _DEFAULT_SOURCE  // usleep under -std=c11
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #pragma comment(lib, "ws2_32.lib")
+    typedef int socklen_t;
+    #define sleep_ms(ms) Sleep(ms)
+#else
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <unistd.h>
+    #define closesocket close
+    #define sleep_ms(ms) usleep((ms) * 1000)
+    typedef int SOCKET;
+#endif
+
+#include "../src/protocol.h"
+
+// Polls a local server's metrics endpoint and prints each snapshot.
+// Usage: stats_client [port] [interval_ms] [count (0 = forever)]
+
+#define SERVER_IP "127.0.0.1"
+#define DEFAULT_PORT 12345
+#define REPLY_TIMEOUT_MS 500
+
+static void print_header(const StatsMessage* s) {
+    printf("=== tick %u - wave %u - %u clients ===\n", s->tick, s->current_wave, s->client_count);
+    printf("  tick time:  p50 %.3f ms - p99 %.3f ms - max %.3f ms over %u ticks (%u overruns)\n",
+           s->tick_p50_us / 1000.0, s->tick_p99_us / 1000.0, s->tick_max_us / 1000.0,
+           s->profile_ticks, s->tick_overruns);
+    printf("  entities:   %u players - %u enemies - %u projectiles\n",
+           s->entity_counts[0], s->entity_counts[1], s->entity_counts[2]);
+    printf("  dropped:    %u inputs - %u projectiles - %u log records\n",
+           s->inputs_dropped, s->projectiles_dropped, s->log_dropped);
+    printf("  heap:       %llu allocs - %llu frees - %llu bytes requested - %u tick allocs this second\n",
+           (unsigned long long)s->heap_allocs, (unsigned long long)s->heap_frees,
+           (unsigned long long)s->heap_bytes, s->tick_allocs);
+}
+
+static void print_clients(const StatsMessage* s) {
+    for (int i = 0; i < s->client_records; i++) {
+        const ClientStats* c = &s->clients[i];
+        printf("  player %-6u rtt %7.2f ms - sent %8u pkts / %10llu B - received %8u pkts / %10llu B\n",
+               c->player_id, c->rtt_us / 1000.0,
+               c->packets_sent, (unsigned long long)c->bytes_sent,
+               c->packets_received, (unsigned long long)c->bytes_received);
+    }
+}
+
+int main(int argc, char** argv) {
+    int port = argc > 1 ? atoi(argv[1]) : DEFAULT_PORT;
+    int interval_ms = argc > 2 ? atoi(argv[2]) : 1000;
+    int count = argc > 3 ? atoi(argv[3]) : 0;
+
+#ifdef _WIN32
+    WSADATA wsa;
+    WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+
+    SOCKET sock = socket(AF_INET, SOCK_DGRAM, 0);
+
+#ifdef _WIN32
+    DWORD timeout = REPLY_TIMEOUT_MS;
+#else
+    struct timeval timeout = {0, REPLY_TIMEOUT_MS * 1000};
+#endif
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+
+    struct sockaddr_in server_addr;
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons((unsigned short)port);
+    server_addr.sin_addr.s_addr = inet_addr(SERVER_IP);
+
+    uint8_t buffer[MAX_PACKET_SIZE];
+    ClientStats clients[STATS_MAX_CLIENTS];
+
+    for (int poll = 0; count == 0 || poll < count; poll++) {
+        // One request per page of clients
+        uint16_t first_client = 0;
+        int page = 0;
+        do {
+            int size = serialize_stats_request(first_client, buffer, sizeof(buffer));
+            sendto(sock, (char*)buffer, size, 0, (struct sockaddr*)&server_addr, sizeof(server_addr));
+
+            int recv_len = recvfrom(sock, (char*)buffer, sizeof(buffer), 0, NULL, NULL);
+            StatsMessage stats;
+            stats.clients = clients;
+            stats.client_capacity = STATS_MAX_CLIENTS;
+            if (recv_len <= 0 || buffer[0] != MSG_STATS ||
+                deserialize_stats(buffer, recv_len, &stats) < 0) {
+                printf("No reply from %s:%d\n", SERVER_IP, port);
+                break;
+            }
+
+            if (page++ == 0) print_header(&stats);
+            print_clients(&stats);
+            first_client = stats.next_client;
+        } while (first_client != 0);
+
+        fflush(stdout);
+        sleep_ms(interval_ms);
+    }
+
+    closesocket(sock);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return 0;
+}
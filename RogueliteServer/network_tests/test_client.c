@@ -24,6 +24,19 @@
 
 #define SERVER_IP "127.0.0.1"
 #define SERVER_PORT 12345
+#define STATE_HISTORY 32   // Decoded states kept as delta baselines (matches the server ring)
+#define MAX_ENTITIES 2048
+
+// One tick's state, assembled from its fragments
+typedef struct {
+    StateMessage state;
+    EntityState entities[MAX_ENTITIES];
+    uint32_t received;      // Bit per fragment index
+    int fragment_count;     // Known once the last fragment arrives (0 until then)
+    int complete;           // All fragments in: usable as a baseline
+} DecodedState;
+
+static DecodedState history[STATE_HISTORY];
 
 int main() {
     printf("=== TEST CLIENT ===\n");
@@ -94,13 +107,52 @@ int main() {
                                (struct sockaddr*)&from_addr, &from_len);
         
         if (recv_len > 0 && buffer[0] == MSG_STATE) {
+            // Find the state this delta was encoded against (tick 0 = full state)
+            uint32_t baseline_tick = state_baseline_tick(buffer, recv_len);
+            const StateMessage* baseline = NULL;
+            if (baseline_tick != 0) {
+                DecodedState* slot = &history[baseline_tick % STATE_HISTORY];
+                if (slot->state.tick == baseline_tick && slot->complete) baseline = &slot->state;
+            }
+            
             StateMessage state;
-            deserialize_state(buffer, recv_len, &state);
+            EntityState entities[MAX_ENTITIES];
+            state.entities = entities;
+            state.entity_capacity = MAX_ENTITIES;
+            state.players = NULL;  // Names only printed by the real client
+            state.player_capacity = 0;
+            if (deserialize_state(buffer, recv_len, baseline, &state) < 0) {
+                continue;  // Baseline gone; the server resends once it sees no ACK
+            }
+            
+            // Add the fragment to its tick's state
+            DecodedState* slot = &history[state.tick % STATE_HISTORY];
+            if (slot->state.tick != state.tick) {
+                slot->state = state;
+                slot->state.entities = slot->entities;
+                slot->state.entity_capacity = MAX_ENTITIES;
+                slot->state.entity_count = 0;
+                slot->received = 0;
+                slot->fragment_count = 0;
+                slot->complete = 0;
+            }
+            if (slot->complete || (slot->received & (1u << state.fragment_index))) continue;
+            state_apply_fragment(&slot->state, &state);
+            slot->received |= 1u << state.fragment_index;
+            if (state.last_fragment) slot->fragment_count = state.fragment_index + 1;
+            
+            if (slot->fragment_count == 0 ||
+                slot->received != (uint32_t)((1ull << slot->fragment_count) - 1)) continue;
+            slot->complete = 1;
+            
+            // Whole tick in: tell the server it can encode against this state
+            int ack_size = serialize_ack(state.tick, buffer, sizeof(buffer));
+            sendto(sock, (char*)buffer, ack_size, 0, (struct sockaddr*)&server_addr, sizeof(server_addr));
             
             if (tick % 60 == 0) {  // Print every second
-                printf("Tick %u - Entities: %u\n", state.tick, state.entity_count);
-                for (int i = 0; i < state.entity_count; i++) {
-                    EntityState* e = &state.entities[i];
+                printf("Tick %u - Entities: %u\n", slot->state.tick, slot->state.entity_count);
+                for (int i = 0; i < slot->state.entity_count; i++) {
+                    EntityState* e = &slot->state.entities[i];
                     printf("  ID %u: type=%u pos=(%.1f, %.1f) hp=%d\n",
                            e->entity_id, e->entity_type, e->x, e->y, e->health);
                 }
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include "../src/protocol.h"
 
 void print_hex(const uint8_t* buffer, int size) {
@@ -10,6 +11,22 @@ void print_hex(const uint8_t* buffer, int size) {
     printf("\n");
 }
 
+// Field-by-field compare, allowing for quantization (half a step)
+static int entities_equal(const EntityState* a, const EntityState* b, int count) {
+    const float position_tolerance = 0.5f / STATE_POSITION_SCALE;
+    const float rotation_tolerance = 3.14159265f / (1 << STATE_ROTATION_BITS) + 1e-4f;
+    for (int i = 0; i < count; i++) {
+        float rotation_error = fabsf(remainderf(a[i].rotation - b[i].rotation, 6.28318531f));
+        if (a[i].entity_id != b[i].entity_id || a[i].entity_type != b[i].entity_type ||
+            fabsf(a[i].x - b[i].x) > position_tolerance || fabsf(a[i].y - b[i].y) > position_tolerance ||
+            a[i].health != b[i].health || a[i].max_health != b[i].max_health ||
+            rotation_error > rotation_tolerance || a[i].active != b[i].active) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
 int main() {
     printf("=== PROTOCOL TEST ===\n\n");
     
@@ -41,25 +58,40 @@ int main() {
            (input_copy.keys & KEY_D) != 0);
     printf("  Mouse: (%.2f, %.2f)\n\n", input_copy.mouse_x, input_copy.mouse_y);
     
-    // Test 2: STATE message
+    // Test 2: STATE message (full, no baseline)
     printf("Test 2: STATE Message\n");
     printf("---------------------\n");
     
+    EntityState entities[3] = {
+        {1, 0, 100.0f, 200.0f, 100, 100, 0.0f, true},
+        {2, 1, 300.0f, 400.0f, 50, 50, 1.5f, true},
+        {3, 2, 150.0f, 250.0f, 1, 1, 3.0f, true}
+    };
+    PlayerInfo players[2] = {{1, "Alice"}, {7, "Bob"}};
+    
     StateMessage state = {
         .tick = 12345,
-        .entity_count = 3
+        .current_wave = 2,
+        .wave_active = 1,
+        .entity_count = 3,
+        .entities = entities,
+        .player_count = 2,
+        .players = players
     };
     
-    state.entities[0] = (EntityState){1, 0, 100.0f, 200.0f, 100, true};
-    state.entities[1] = (EntityState){2, 1, 300.0f, 400.0f, 50, true};
-    state.entities[2] = (EntityState){3, 2, 150.0f, 250.0f, 1, true};
-    
-    size = serialize_state(&state, buffer, sizeof(buffer));
+    size = serialize_state(NULL, &state, buffer, sizeof(buffer));
     printf("Serialized %d bytes:\n", size);
     print_hex(buffer, size);
     
-    StateMessage state_copy;
-    deserialize_state(buffer, size, &state_copy);
+    EntityState entities_copy[8];
+    PlayerInfo players_copy[8];
+    StateMessage state_copy = {
+        .entity_capacity = 8,
+        .entities = entities_copy,
+        .player_capacity = 8,
+        .players = players_copy
+    };
+    deserialize_state(buffer, size, NULL, &state_copy);
     
     printf("Deserialized:\n");
     printf("  Tick: %u\n", state_copy.tick);
@@ -69,7 +101,227 @@ int main() {
         printf("    Entity %u: type=%u pos=(%.1f,%.1f) hp=%d\n",
                e->entity_id, e->entity_type, e->x, e->y, e->health);
     }
+    printf("  Players: %u\n", state_copy.player_count);
+    for (int i = 0; i < state_copy.player_count; i++) {
+        printf("    Player %u: %s\n", state_copy.players[i].player_id, state_copy.players[i].name);
+    }
+    if (state_copy.entity_count != 3 || !entities_equal(state_copy.entities, entities, 3)) {
+        printf("FAILED: entities did not round-trip\n");
+        return 1;
+    }
+    if (state_copy.player_count != 2 || strcmp(state_copy.players[1].name, "Bob") != 0) {
+        printf("FAILED: player list did not round-trip\n");
+        return 1;
+    }
+    
+    // Test 3: STATE delta against an acknowledged baseline
+    printf("\nTest 3: STATE Delta\n");
+    printf("-------------------\n");
+    
+    // Entity 1 moves, 2 is unchanged, 3 is gone, 5 is new; no new names
+    EntityState next_entities[3] = {
+        {1, 0, 110.0f, 205.0f, 100, 100, 0.0f, true},
+        entities[1],
+        {5, 2, 50.0f, 60.0f, 1, 1, 0.5f, true}
+    };
+    StateMessage next = state;
+    next.tick = 12346;
+    next.entity_count = 3;
+    next.entities = next_entities;
+    next.player_count = 0;
+    
+    size = serialize_state(&state_copy, &next, buffer, sizeof(buffer));
+    printf("Serialized %d bytes (baseline tick %u):\n", size, state_baseline_tick(buffer, size));
+    print_hex(buffer, size);
+    
+    // Bits: id gap (2+4) + flags (6) on each record, then
+    //   1: position (2*14)                            = 40
+    //   3: removed                                    = 12
+    //   5: type (2) + position (28) + max_health (16)
+    //      + health (1 bit for max 1) + rotation (9)   = 68
+    // 120 bits = 15 bytes between the two counts
+    int expected = STATE_HEADER_SIZE + 2 + 15 + 2;
+    if (size != expected) {
+        printf("FAILED: delta was %d bytes, expected %d\n", size, expected);
+        return 1;
+    }
+    
+    EntityState next_copy_entities[8];
+    StateMessage next_copy = {
+        .entity_capacity = 8,
+        .entities = next_copy_entities,
+        .player_capacity = 8,
+        .players = players_copy
+    };
+    if (deserialize_state(buffer, size, &state_copy, &next_copy) < 0 ||
+        next_copy.entity_count != 3 ||
+        !entities_equal(next_copy.entities, next_entities, 3)) {
+        printf("FAILED: delta did not reconstruct the state\n");
+        return 1;
+    }
+    printf("Reconstructed %u entities from the delta\n", next_copy.entity_count);
+    
+    // Nothing changed: header and two empty sections only
+    size = serialize_state(&next_copy, &next, buffer, sizeof(buffer));
+    if (size != STATE_HEADER_SIZE + 4) {
+        printf("FAILED: unchanged state encoded as %d bytes\n", size);
+        return 1;
+    }
+    
+    // Moves smaller than a quantization step aren't changes either
+    EntityState jitter_entities[3];
+    memcpy(jitter_entities, next_copy.entities, sizeof(jitter_entities));
+    jitter_entities[0].x += 0.01f;
+    jitter_entities[2].rotation += 0.001f;
+    StateMessage jitter = next;
+    jitter.entities = jitter_entities;
+    size = serialize_state(&next_copy, &jitter, buffer, sizeof(buffer));
+    if (size != STATE_HEADER_SIZE + 4) {
+        printf("FAILED: sub-step change encoded as %d bytes\n", size);
+        return 1;
+    }
+    
+    // A delta can't be decoded without its baseline
+    size = serialize_state(&state_copy, &next, buffer, sizeof(buffer));
+    if (deserialize_state(buffer, size, NULL, &next_copy) != -1 ||
+        deserialize_state(buffer, size, &next, &next_copy) != -1) {
+        printf("FAILED: delta decoded against the wrong baseline\n");
+        return 1;
+    }
+    printf("Unchanged state: %d bytes, wrong baseline rejected\n", STATE_HEADER_SIZE + 4);
+    
+    // Test 4: STATE split across fragments
+    printf("\nTest 4: STATE Fragments\n");
+    printf("-----------------------\n");
+    
+    enum { BIG = 600 };
+    static EntityState big[BIG];
+    for (int i = 0; i < BIG; i++) {
+        big[i] = (EntityState){(uint32_t)(i + 1), 1, (i % 150) * 10.0f - 300.0f, (i / 150) * 100.0f,
+                               40, 50, 0.25f, true};
+    }
+    
+    // Same loop as the server: start a new fragment whenever a record doesn't fit
+    static uint8_t fragments[STATE_MAX_FRAGMENTS][MAX_PACKET_SIZE];
+    int fragment_sizes[STATE_MAX_FRAGMENTS];
+    int fragment_count = 0;
+    uint32_t range_start = STATE_RANGE_ALL_START;
+    StateMessage big_state = state;
+    big_state.tick = 500;
+    
+    StateWriter w;
+    state_writer_begin(&w, fragments[0], MAX_PACKET_SIZE, &big_state, 0, 0);
+    for (int i = 0; i < BIG; i++) {
+        if (state_writer_entity(&w, NULL, &big[i])) continue;
+        fragment_sizes[fragment_count] = state_writer_finish(&w, range_start, big[i].entity_id - 1, false);
+        range_start = big[i].entity_id;
+        fragment_count++;
+        state_writer_begin(&w, fragments[fragment_count], MAX_PACKET_SIZE, &big_state, 0,
+                           (uint8_t)fragment_count);
+        state_writer_entity(&w, NULL, &big[i]);
+    }
+    fragment_sizes[fragment_count] = state_writer_finish(&w, range_start, STATE_RANGE_ALL_LAST, true);
+    fragment_count++;
+    printf("%d entities in %d fragments\n", BIG, fragment_count);
+    
+    // Reassemble, skipping fragment 1 to simulate a lost packet
+    static EntityState assembled_entities[BIG];
+    StateMessage assembled = {.entity_capacity = BIG, .entities = assembled_entities};
+    static EntityState fragment_entities[BIG];
+    StateMessage fragment = {.entity_capacity = BIG, .entities = fragment_entities};
+    uint32_t lost_start = 0, lost_last = 0;
+    int last_seen = 0;
+    for (int i = 0; i < fragment_count; i++) {
+        if (deserialize_state(fragments[i], fragment_sizes[i], NULL, &fragment) != fragment_sizes[i] ||
+            fragment.fragment_index != i || fragment.tick != 500) {
+            printf("FAILED: fragment %d did not decode\n", i);
+            return 1;
+        }
+        last_seen += fragment.last_fragment;
+        if (i == 1) {
+            lost_start = fragment.range_start;
+            lost_last = fragment.range_last;
+            continue;
+        }
+        state_apply_fragment(&assembled, &fragment);
+    }
+    
+    int expected_count = BIG - (int)(lost_last - lost_start + 1);
+    if (fragment_count < 3 || last_seen != 1 || assembled.entity_count != expected_count) {
+        printf("FAILED: fragments reassembled to %u entities, expected %d\n",
+               assembled.entity_count, expected_count);
+        return 1;
+    }
+    for (int i = 0, j = 0; i < BIG; i++) {
+        if (big[i].entity_id >= lost_start && big[i].entity_id <= lost_last) continue;
+        if (!entities_equal(&assembled.entities[j++], &big[i], 1)) {
+            printf("FAILED: entity %u wrong after reassembly\n", big[i].entity_id);
+            return 1;
+        }
+    }
+    printf("Lost fragment 1 (IDs %u-%u): other %u entities intact\n",
+           lost_start, lost_last, assembled.entity_count);
+    
+    // Test 5: ACK message
+    printf("\nTest 5: ACK Message\n");
+    printf("-------------------\n");
     
+    uint32_t acked = 0;
+    size = serialize_ack(12346, buffer, sizeof(buffer));
+    if (deserialize_ack(buffer, size, &acked) != 5 || buffer[0] != MSG_ACK || acked != 12346) {
+        printf("FAILED: ACK did not round-trip\n");
+        return 1;
+    }
+    printf("ACK tick %u\n", acked);
+
+    // Test 6: STATS request and a full page of clients
+    printf("\nTest 6: STATS Message\n");
+    printf("---------------------\n");
+
+    uint16_t first_client = 0;
+    size = serialize_stats_request(40, buffer, sizeof(buffer));
+    if (deserialize_stats_request(buffer, size, &first_client) != 3 ||
+        buffer[0] != MSG_STATS_REQUEST || first_client != 40) {
+        printf("FAILED: STATS_REQUEST did not round-trip\n");
+        return 1;
+    }
+
+    ClientStats stats_clients[STATS_MAX_CLIENTS];
+    for (int i = 0; i < STATS_MAX_CLIENTS; i++) {
+        stats_clients[i].player_id = 65536u + (uint32_t)i;
+        stats_clients[i].rtt_us = 1500u + (uint32_t)i;
+        stats_clients[i].bytes_sent = 5000000000ull + (uint64_t)i;  // Past 32 bits
+        stats_clients[i].bytes_received = 12345u * (uint64_t)i;
+        stats_clients[i].packets_sent = 100u * (uint32_t)i;
+        stats_clients[i].packets_received = 60u * (uint32_t)i;
+    }
+    StatsMessage stats = {
+        .tick = 7200, .current_wave = 4, .client_count = 80,
+        .profile_ticks = 600, .tick_p50_us = 700, .tick_p99_us = 3100, .tick_max_us = 4400,
+        .tick_overruns = 2, .entity_counts = {80, 9, 130},
+        .inputs_dropped = 1, .projectiles_dropped = 2, .log_dropped = 3,
+        .heap_allocs = 12000, .heap_frees = 11000, .heap_bytes = 1ull << 33, .tick_allocs = 0,
+        .next_client = 41, .client_records = STATS_MAX_CLIENTS, .clients = stats_clients
+    };
+    size = serialize_stats(&stats, buffer, sizeof(buffer));
+
+    ClientStats decoded_clients[STATS_MAX_CLIENTS];
+    StatsMessage decoded_stats = {.client_capacity = STATS_MAX_CLIENTS, .clients = decoded_clients};
+    if (size != STATS_HEADER_SIZE + STATS_MAX_CLIENTS * STATS_CLIENT_SIZE || size > MAX_PACKET_SIZE ||
+        deserialize_stats(buffer, size, &decoded_stats) != size) {
+        printf("FAILED: STATS size %d\n", size);
+        return 1;
+    }
+    if (decoded_stats.tick != 7200 || decoded_stats.current_wave != 4 || decoded_stats.client_count != 80 ||
+        decoded_stats.tick_p99_us != 3100 || decoded_stats.entity_counts[2] != 130 ||
+        decoded_stats.log_dropped != 3 || decoded_stats.heap_bytes != (1ull << 33) ||
+        decoded_stats.next_client != 41 || decoded_stats.client_records != STATS_MAX_CLIENTS ||
+        memcmp(decoded_clients, stats_clients, sizeof(stats_clients)) != 0) {
+        printf("FAILED: STATS did not round-trip\n");
+        return 1;
+    }
+    printf("STATS with %d clients: %d bytes\n", STATS_MAX_CLIENTS, size);
+
     printf("\n=== ALL TESTS PASSED ===\n");
     
     return 0;
@@ -1,7 +1,10 @@
 #include "ai.h"
-#include <stdio.h>
-#include <stdlib.h>
+#include "log.h"
+#include "rng.h"
+#include "memory.h"
+#include "collision.h"
 #include <math.h>
+#include <float.h>
 
 #define CHASE_RANGE 300.0f      // Start chasing if player within 300 pixels
 #define ATTACK_RANGE 200.0f     // Attack if player within 200 pixels
@@ -9,151 +12,266 @@
 #define WANDER_SPEED 50.0f      // Wander movement speed
 #define CHASE_SPEED 80.0f       // Chase movement speed
 #define PROJECTILE_SPEED 200.0f // Projectile speed
+#define LOSE_RANGE (CHASE_RANGE + 50.0f)    // Chasing enemies give up beyond this
+#define ESCAPE_RANGE (ATTACK_RANGE + 50.0f) // Attacking enemies go back to chasing beyond this
+#define TARGET_RANGE LOSE_RANGE             // Players further away never affect an enemy
+#define WANDER_ARRIVE 5.0f                  // Close enough to the wander target
 
-// Update single enemy AI
-void ai_update_enemy(Entity* enemy, Entity* player, float delta_time, EntityManager* em) {
-    if (!enemy->active || !player->active) return;
+// Range checks compare squared distances
+#define SQUARED(x) ((x) * (x))
+
+// Decide one enemy's next AI state (reads the world, writes only *out)
+void ai_decide_enemy(const EntityManager* em, const TargetGrid* targets, size_t index,
+                     float delta_time, uint64_t seed, uint32_t tick, AIDecision* out) {
+    const Entity* enemy = &em->entities[index];
+    out->decided = enemy->active;
+    if (!enemy->active) return;
+    
+    out->ai = em->ai[index];
+    out->velocity = vector2_create(em->vel_x[index], em->vel_y[index]);
+    out->rotation = enemy->rotation;
+    out->fire = false;
+    out->chase_target = TARGET_NONE;
+    out->event = AI_EVENT_NONE;
     
-    // Calculate distance to player
-    float dist = vector2_distance(enemy->position, player->position);
+    AIComponent* ai = &out->ai;
+    Vector2 enemy_pos = vector2_create(em->pos_x[index], em->pos_y[index]);
+    
+    // Nearest living player in reach (none: every range check fails)
+    float dist_sq;
+    uint32_t target = target_grid_nearest(targets, em, enemy_pos.x, enemy_pos.y, TARGET_RANGE, &dist_sq);
+    Vector2 player_pos = enemy_pos;
+    if (target != TARGET_NONE) {
+        player_pos = vector2_create(em->pos_x[target], em->pos_y[target]);
+    } else {
+        dist_sq = FLT_MAX;
+    }
     
     // Update timers
-    enemy->ai.state_timer += delta_time;
-    if (enemy->ai.attack_cooldown > 0.0f) {
-        enemy->ai.attack_cooldown -= delta_time;
+    ai->state_timer += delta_time;
+    if (ai->attack_cooldown > 0.0f) {
+        ai->attack_cooldown -= delta_time;
     }
     
     // State machine
-    switch (enemy->ai.state) {
+    switch (ai->state) {
         case AI_STATE_IDLE:
             // Transition to wander after 1 second
-            if (enemy->ai.state_timer > 1.0f) {
-                enemy->ai.state = AI_STATE_WANDER;
-                enemy->ai.state_timer = 0.0f;
+            if (ai->state_timer > 1.0f) {
+                ai->state = AI_STATE_WANDER;
+                ai->state_timer = 0.0f;
                 
                 // Pick random wander target
-                float angle = (float)rand() / RAND_MAX * 6.28f;  // Random angle
-                float distance = 50.0f + (float)rand() / RAND_MAX * 100.0f;
-                enemy->ai.wander_target.x = enemy->position.x + cosf(angle) * distance;
-                enemy->ai.wander_target.y = enemy->position.y + sinf(angle) * distance;
+                Rng rng = rng_for_entity(seed, enemy->id, tick);
+                float angle = rng_range(&rng, 0.0f, 6.28f);  // Random angle
+                float distance = rng_range(&rng, 50.0f, 150.0f);
+                ai->wander_target.x = enemy_pos.x + cosf(angle) * distance;
+                ai->wander_target.y = enemy_pos.y + sinf(angle) * distance;
             }
             break;
             
         case AI_STATE_WANDER:
             // Check if player is nearby
-            if (dist < CHASE_RANGE) {
-                enemy->ai.state = AI_STATE_CHASE;
-                enemy->ai.state_timer = 0.0f;
-                printf("Enemy %u: CHASE!\n", enemy->id);
+            if (dist_sq < SQUARED(CHASE_RANGE)) {
+                ai->state = AI_STATE_CHASE;
+                ai->state_timer = 0.0f;
+                out->event = AI_EVENT_CHASE;
                 break;
             }
             
             // Move toward wander target
-            float wander_dist = vector2_distance(enemy->position, enemy->ai.wander_target);
-            if (wander_dist > 5.0f) {
-                Vector2 direction = vector2_subtract(enemy->ai.wander_target, enemy->position);
-                float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
-                if (length > 0.0f) {
-                    direction.x /= length;
-                    direction.y /= length;
-                    enemy->velocity = vector2_multiply(direction, WANDER_SPEED);
-                }
+            Vector2 to_wander = vector2_subtract(ai->wander_target, enemy_pos);
+            float wander_dist_sq = to_wander.x * to_wander.x + to_wander.y * to_wander.y;
+            if (wander_dist_sq > SQUARED(WANDER_ARRIVE)) {
+                float length = sqrtf(wander_dist_sq);
+                to_wander.x /= length;
+                to_wander.y /= length;
+                out->velocity = vector2_multiply(to_wander, WANDER_SPEED);
             } else {
                 // Reached target, go idle
-                enemy->velocity = vector2_create(0.0f, 0.0f);
-                enemy->ai.state = AI_STATE_IDLE;
-                enemy->ai.state_timer = 0.0f;
+                out->velocity = vector2_create(0.0f, 0.0f);
+                ai->state = AI_STATE_IDLE;
+                ai->state_timer = 0.0f;
             }
             break;
             
         case AI_STATE_CHASE:
             // Check if in attack range
-            if (dist < ATTACK_RANGE) {
-                enemy->ai.state = AI_STATE_ATTACK;
-                enemy->ai.state_timer = 0.0f;
-                enemy->velocity = vector2_create(0.0f, 0.0f);  // Stop moving
-                printf("Enemy %u: ATTACK!\n", enemy->id);
+            if (dist_sq < SQUARED(ATTACK_RANGE)) {
+                ai->state = AI_STATE_ATTACK;
+                ai->state_timer = 0.0f;
+                out->velocity = vector2_create(0.0f, 0.0f);  // Stop moving
+                out->event = AI_EVENT_ATTACK;
                 break;
             }
             
             // Check if player escaped
-            if (dist > CHASE_RANGE + 50.0f) {
-                enemy->ai.state = AI_STATE_WANDER;
-                enemy->ai.state_timer = 0.0f;
-                printf("Enemy %u: Lost player\n", enemy->id);
+            if (dist_sq > SQUARED(LOSE_RANGE)) {
+                ai->state = AI_STATE_WANDER;
+                ai->state_timer = 0.0f;
+                out->event = AI_EVENT_LOST;
                 break;
             }
             
-            // Chase player
-            Vector2 direction = vector2_subtract(player->position, enemy->position);
+            // Chase player: straight at them unless their flow field knows a path
+            Vector2 direction = vector2_subtract(player_pos, enemy_pos);
             float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
             if (length > 0.0f) {
                 direction.x /= length;
                 direction.y /= length;
-                enemy->velocity = vector2_multiply(direction, CHASE_SPEED);
-                enemy->rotation = atan2f(direction.y, direction.x);  // Face movement direction
+                out->velocity = vector2_multiply(direction, CHASE_SPEED);
+                out->rotation = atan2f(direction.y, direction.x);  // Face movement direction
             }
+            out->chase_target = target;
             break;
             
         case AI_STATE_ATTACK:
             // Check if player moved away
-            if (dist > ATTACK_RANGE + 50.0f) {
-                enemy->ai.state = AI_STATE_CHASE;
-                enemy->ai.state_timer = 0.0f;
-                printf("Enemy %u: Player escaped, chasing\n", enemy->id);
+            if (dist_sq > SQUARED(ESCAPE_RANGE)) {
+                ai->state = AI_STATE_CHASE;
+                ai->state_timer = 0.0f;
+                out->event = AI_EVENT_ESCAPED;
                 break;
             }
             
             // Attack (shoot projectile)
-            if (enemy->ai.attack_cooldown <= 0.0f) {
+            if (ai->attack_cooldown <= 0.0f) {
                 // Calculate direction to player
-                Vector2 direction = vector2_subtract(player->position, enemy->position);
+                Vector2 direction = vector2_subtract(player_pos, enemy_pos);
                 float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
                 if (length > 0.0f) {
                     direction.x /= length;
                     direction.y /= length;
-                    enemy->rotation = atan2f(direction.y, direction.x);  // Face target
+                    out->rotation = atan2f(direction.y, direction.x);  // Face target
                 }
                 
-                // Create projectile 20px away from enemy (avoid self-hit)
-                Vector2 projectile_pos;
-                projectile_pos.x = enemy->position.x + direction.x * 20.0f;
-                projectile_pos.y = enemy->position.y + direction.y * 20.0f;
-                
-                Entity* projectile = entity_create(em, ENTITY_TYPE_PROJECTILE, projectile_pos);
-                if (projectile) {
-                    projectile->velocity = vector2_multiply(direction, PROJECTILE_SPEED);
-                    projectile->owner_id = enemy->id;  // Track who shot it
-                    projectile->rotation = enemy->rotation;  // Projectile faces same direction
-                    printf("Enemy %u fired projectile!\n", enemy->id);
-                }
+                // Projectile 20px away from enemy (avoid self-hit), spawned in the apply phase
+                out->fire = true;
+                out->projectile_pos.x = enemy_pos.x + direction.x * 20.0f;
+                out->projectile_pos.y = enemy_pos.y + direction.y * 20.0f;
+                out->projectile_vel = vector2_multiply(direction, PROJECTILE_SPEED);
                 
                 // Reset cooldown
-                enemy->ai.attack_cooldown = ATTACK_COOLDOWN;
+                ai->attack_cooldown = ATTACK_COOLDOWN;
             }
             break;
     }
 }
 
-// Update all enemies
-void ai_update_all(EntityManager* em, float delta_time) {
-    // Find player
-    Entity* player = NULL;
-    for (size_t i = 0; i < em->count; i++) {
-        if (em->entities[i].type == ENTITY_TYPE_PLAYER && em->entities[i].active) {
-            player = &em->entities[i];
-            break;
+// Shared, read-only inputs of one tick's decision phase
+typedef struct {
+    const EntityManager* em;
+    const TargetGrid* targets;
+    AIDecision* decisions;
+    float delta_time;
+    uint64_t seed;
+    uint32_t tick;
+} AIDecideJob;
+
+static void ai_decide_range(void* context, size_t begin, size_t end) {
+    const AIDecideJob* job = context;
+    for (size_t i = begin; i < end; i++) {
+        if (job->em->entities[i].type == ENTITY_TYPE_ENEMY) {
+            ai_decide_enemy(job->em, job->targets, i, job->delta_time,
+                            job->seed, job->tick, &job->decisions[i]);
+        } else {
+            job->decisions[i].decided = false;
         }
     }
+}
+
+// Follow the target's flow field from the enemy's centre (constant time
+// once the field is built); keeps the straight-line decision otherwise
+static void ai_steer_chase(FlowFieldSet* flow, EntityManager* em, size_t index, uint32_t target) {
+    const FlowField* field = flow_field_for_player(flow, em, target);
+    if (field == NULL) return;
     
-    if (!player) return;  // No player, no AI
-    
-    // Update each enemy
+    Vector2 direction;
+    if (!flow_field_direction(flow, field, em->pos_x[index] + ENEMY_SIZE * 0.5f,
+                              em->pos_y[index] + ENEMY_SIZE * 0.5f, &direction)) {
+        return;
+    }
+    em->vel_x[index] = direction.x * CHASE_SPEED;
+    em->vel_y[index] = direction.y * CHASE_SPEED;
+    em->entities[index].rotation = atan2f(direction.y, direction.x);
+}
+
+// Serial, in entity order: projectile IDs, log order and flow field
+// builds never depend on threads
+static void ai_apply(AISystem* ai, EntityManager* em, ProjectilePool* projectiles) {
     for (size_t i = 0; i < em->count; i++) {
+        const AIDecision* d = &ai->decisions[i];
+        if (!d->decided) continue;
+        
         Entity* enemy = &em->entities[i];
+        em->ai[i] = d->ai;
+        em->vel_x[i] = d->velocity.x;
+        em->vel_y[i] = d->velocity.y;
+        enemy->rotation = d->rotation;
+        if (d->chase_target != TARGET_NONE) {
+            ai_steer_chase(&ai->flow, em, i, d->chase_target);
+        }
+        switch (d->event) {
+            case AI_EVENT_CHASE:   LOG_DEBUG("Enemy %u: CHASE!\n", enemy->id); break;
+            case AI_EVENT_ATTACK:  LOG_DEBUG("Enemy %u: ATTACK!\n", enemy->id); break;
+            case AI_EVENT_LOST:    LOG_DEBUG("Enemy %u: Lost player\n", enemy->id); break;
+            case AI_EVENT_ESCAPED: LOG_DEBUG("Enemy %u: Player escaped, chasing\n", enemy->id); break;
+        }
         
-        if (enemy->type == ENTITY_TYPE_ENEMY && enemy->active) {
-            ai_update_enemy(enemy, player, delta_time, em);
+        if (d->fire) {
+            uint32_t projectile_id = projectile_spawn(projectiles, d->projectile_pos, d->projectile_vel,
+                                                      enemy->id,      // Track who shot it
+                                                      d->rotation);   // Projectile faces same direction
+            if (projectile_id) {
+                LOG_DEBUG("Enemy %u fired projectile!\n", enemy->id);
+            }
         }
     }
-}
\ No newline at end of file
+}
+
+void ai_system_init(AISystem* ai, int thread_count, const Dungeon* dungeon,
+                    float min_x, float min_y, float max_x, float max_y) {
+    worker_pool_init(&ai->workers, thread_count);
+    target_grid_init(&ai->targets, min_x, min_y, max_x, max_y);
+    flow_field_init(&ai->flow, dungeon);
+    ai->decisions = NULL;
+    ai->capacity = 0;
+}
+
+void ai_system_free(AISystem* ai) {
+    worker_pool_free(&ai->workers);
+    target_grid_free(&ai->targets);
+    flow_field_free(&ai->flow);
+    mem_free(ai->decisions);
+    ai->decisions = NULL;
+    ai->capacity = 0;
+}
+
+// Update all enemies
+void ai_update_all(AISystem* ai, EntityManager* em, ProjectilePool* projectiles,
+                   float delta_time, uint64_t seed, uint32_t tick) {
+    // Index this tick's players for the nearest-target queries
+    target_grid_build(&ai->targets, em);
+    flow_field_prune(&ai->flow, em);
+    if (ai->targets.player_count == 0) return;  // No player, no AI
+    
+    // One decision slot per entity (grows with the world, then stays)
+    if (em->count > ai->capacity) {
+        size_t new_capacity = ai->capacity > 0 ? ai->capacity : 64;
+        while (new_capacity < em->count) new_capacity *= 2;
+        AIDecision* grown = mem_realloc(ai->decisions, new_capacity * sizeof(AIDecision));
+        if (grown == NULL) {
+            LOG_ERROR("Failed to grow AI decisions to %zu\n", new_capacity);
+            return;
+        }
+        ai->decisions = grown;
+        ai->capacity = new_capacity;
+    }
+    
+    // 1. Decide: every enemy in parallel, reading only this tick's start state
+    AIDecideJob job = {em, &ai->targets, ai->decisions, delta_time, seed, tick};
+    worker_pool_run(&ai->workers, ai_decide_range, &job, em->count, AI_CHUNK_SIZE);
+    
+    // 2. Apply on this thread
+    ai_apply(ai, em, projectiles);
+}
@@ -2,6 +2,12 @@
 #define AI_H
 
 #include "entity.h"
+#include "projectile_pool.h"
+#include "worker_pool.h"
+#include "target_grid.h"
+#include "flow_field.h"
+#include "dungeon.h"
+#include <stdint.h>
 
 // // AI states
 // typedef enum {
@@ -19,10 +25,58 @@
 //     Vector2 wander_target;    // Random wander destination
 // } AIComponent;
 
-// Update AI for a single enemy
-void ai_update_enemy(Entity* enemy, Entity* player, float delta_time, EntityManager* em);
+// Entities per work item in the decision phase
+#define AI_CHUNK_SIZE 128
 
-// Update AI for all enemies
-void ai_update_all(EntityManager* em, float delta_time);
+typedef enum {
+    AI_EVENT_NONE,
+    AI_EVENT_CHASE,
+    AI_EVENT_ATTACK,
+    AI_EVENT_LOST,
+    AI_EVENT_ESCAPED
+} AIEvent;
+
+// One enemy's decision for this tick, written by the parallel decision
+// phase and committed by the serial apply phase
+typedef struct {
+    AIComponent ai;            // Next AI state
+    Vector2 velocity;
+    float rotation;
+    Vector2 projectile_pos;    // Only if fire
+    Vector2 projectile_vel;
+    uint32_t chase_target;     // Player index to path toward on apply (TARGET_NONE: keep velocity)
+    bool decided;              // False for non-enemies and inactive enemies
+    bool fire;
+    uint8_t event;             // AIEvent to log on apply
+} AIDecision;
+
+typedef struct {
+    WorkerPool workers;
+    TargetGrid targets;        // Active players, rebuilt every tick
+    FlowFieldSet flow;         // Chase paths over the dungeon, one field per chased player
+    AIDecision* decisions;     // Indexed like the entity arrays
+    size_t capacity;
+} AISystem;
+
+// Players are indexed over [min, max] (the map); chasing enemies path
+// around the dungeon's walls
+void ai_system_init(AISystem* ai, int thread_count, const Dungeon* dungeon,
+                    float min_x, float min_y, float max_x, float max_y);
+void ai_system_free(AISystem* ai);
+
+// Decide one enemy's next state from the current world without modifying
+// it. The enemy reacts to its nearest living player (from 'targets').
+// Random choices come from the enemy's own stream for this tick
+// (rng_for_entity(seed, id, tick)), so any thread gets the same answer.
+void ai_decide_enemy(const EntityManager* em, const TargetGrid* targets, size_t index,
+                     float delta_time, uint64_t seed, uint32_t tick, AIDecision* out);
+
+// Update AI for all enemies: decisions in parallel over ai->workers, then
+// velocities, rotations and projectile spawns applied in entity order.
+// Chasing enemies are steered along their target's flow field during the
+// apply, which builds fields on demand. The result is identical for any
+// thread count.
+void ai_update_all(AISystem* ai, EntityManager* em, ProjectilePool* projectiles,
+                   float delta_time, uint64_t seed, uint32_t tick);
 
 #endif
\ No newline at end of file
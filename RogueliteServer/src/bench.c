@@ -0,0 +1,132 @@
+#include "bench.h"
+#include "game_loop.h"
+#include "memory.h"
+#include "timing.h"
+#include "log.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Phases the benchmark runs (game_tick minus timeouts, broadcast and status)
+static const ProfilePhase bench_phases[] = {
+    PHASE_INPUT, PHASE_WAVE, PHASE_AI, PHASE_INTEGRATE,
+    PHASE_CLAMP, PHASE_COLLISION, PHASE_SYNC
+};
+#define BENCH_PHASE_COUNT (sizeof(bench_phases) / sizeof(bench_phases[0]))
+
+// Large (input queue, profiler histograms): keep it off the stack
+static GameState game;
+
+// Players start on random open floor tiles and fire in a fixed direction
+// each (with a slow sweep), so they load the projectile, wall and
+// collision paths; each walks a small square, one side per second
+#define BENCH_AIM_DISTANCE 2000.0f
+
+static float bench_angle(int index, int count) {
+    return 6.2831853f * (float)index / (float)count;
+}
+
+static void bench_queue_inputs(GameState* game, const uint32_t* player_ids, int player_count) {
+    static const uint8_t sides[] = {KEY_W, KEY_D, KEY_S, KEY_A};
+    InputQueue* queue = &game->inputs;
+    int second = game->tick_count / game->config.tick_rate;
+    float sweep = 0.4f * sinf((float)game->tick_count * 0.05f);
+
+    for (int i = 0; i < player_count && queue->count < INPUT_QUEUE_CAPACITY; i++) {
+        Entity* player = entity_get_by_id(&game->entity_manager, player_ids[i]);
+        if (player == NULL) continue;
+        Vector2 position = entity_get_position(&game->entity_manager, player);
+        float aim = bench_angle(i, player_count) + sweep;
+        QueuedInput* queued = &queue->items[(queue->head + queue->count) % INPUT_QUEUE_CAPACITY];
+        queued->player_id = player_ids[i];
+        queued->input.player_id = player_ids[i];
+        queued->input.keys = sides[(second + i) % 4] | KEY_SPACE;
+        queued->input.mouse_x = position.x + cosf(aim) * BENCH_AIM_DISTANCE;
+        queued->input.mouse_y = position.y + sinf(aim) * BENCH_AIM_DISTANCE;
+        queue->count++;
+    }
+}
+
+// FNV-1a over everything the simulation produced
+static uint64_t bench_checksum(const GameState* game) {
+    uint64_t hash = 14695981039346656037ull;
+    const EntityManager* em = &game->entity_manager;
+    for (size_t i = 0; i < em->count; i++) {
+        uint32_t words[4];
+        memcpy(&words[0], &em->pos_x[i], 4);
+        memcpy(&words[1], &em->pos_y[i], 4);
+        words[2] = em->entities[i].id;
+        words[3] = (uint32_t)em->entities[i].health;
+        const uint8_t* bytes = (const uint8_t*)words;
+        for (size_t b = 0; b < sizeof(words); b++) {
+            hash = (hash ^ bytes[b]) * 1099511628211ull;
+        }
+    }
+    hash = (hash ^ (uint64_t)game->projectiles.count) * 1099511628211ull;
+    hash = (hash ^ (uint64_t)game->current_wave) * 1099511628211ull;
+    return hash;
+}
+
+int bench_run(const ServerConfig* config) {
+    game_init(&game, INVALID_SOCKET, config);
+    Profiler* profiler = &game.profiler;
+    float tick_time = 1.0f / (float)config->tick_rate;
+
+    uint32_t* player_ids = mem_alloc((size_t)config->bench_players * sizeof(uint32_t));
+    if (player_ids == NULL) {
+        fprintf(stderr, "Failed to allocate bench players!\n");
+        return 1;
+    }
+    for (int i = 0; i < config->bench_players; i++) {
+        Vector2 position = dungeon_random_spawn(&game.dungeon, &game.rng);
+        player_ids[i] = entity_spawn(&game.entity_manager, ENTITY_TYPE_PLAYER, position,
+                                     vector2_create(0.0f, 0.0f), 0, 0.0f);
+    }
+    for (int w = 0; w < config->bench_waves; w++) {
+        wave_start(&game);
+    }
+    entity_apply_commands(&game.entity_manager);
+
+    uint64_t entity_ticks = 0;    // Entities (incl. projectiles) summed over ticks
+    uint64_t start = timing_now_ns();
+
+    for (int t = 0; t < config->bench_ticks; t++) {
+        entity_ticks += game.entity_manager.count + game.projectiles.count;
+        profiler_begin_tick(profiler);
+        game.tick_count++;
+        game.total_time += tick_time;
+
+        bench_queue_inputs(&game, player_ids, config->bench_players);
+        game_simulate(&game, tick_time);
+        profiler_end_tick(profiler);
+    }
+
+    double seconds = (double)(timing_now_ns() - start) / (double)NS_PER_SECOND;
+    double ticks = (double)config->bench_ticks;
+    double entities = (double)entity_ticks / ticks;
+
+    LOG_INFO("\n=== BENCH: %d ticks, %d players, %d waves, seed %u, %d AI threads ===\n",
+             config->bench_ticks, config->bench_players, config->bench_waves, config->seed,
+             config->ai_threads);
+    LOG_INFO("%.0f ticks/s (%.1fx real time at %d Hz) - %.1f entities/tick avg - reached wave %d\n",
+             ticks / seconds, ticks / seconds / config->tick_rate, config->tick_rate,
+             entities, game.current_wave);
+    LOG_INFO("  %-10s %10s %10s %10s %10s\n", "phase", "ns/tick", "ns/entity", "p99 ns", "max ns");
+    for (size_t i = 0; i < BENCH_PHASE_COUNT; i++) {
+        const Histogram* h = &profiler->phases[bench_phases[i]];
+        PhaseSummary s = profiler_phase_summary(profiler, bench_phases[i]);
+        LOG_INFO("  %-10s %10.0f %10.2f %10llu %10llu\n",
+                 profiler_phase_name(bench_phases[i]), (double)h->sum / ticks,
+                 (double)h->sum / (double)entity_ticks,
+                 (unsigned long long)s.p99_ns, (unsigned long long)s.max_ns);
+    }
+    const Histogram* h = &profiler->tick;
+    LOG_INFO("  %-10s %10.0f %10.2f %10llu %10llu\n", "tick", (double)h->sum / ticks,
+             (double)h->sum / (double)entity_ticks,
+             (unsigned long long)profiler_tick_summary(profiler).p99_ns, (unsigned long long)h->max);
+    LOG_INFO("Checksum: %016llx\n", (unsigned long long)bench_checksum(&game));
+
+    mem_free(player_ids);
+    game_cleanup(&game);
+    return 0;
+}
@@ -0,0 +1,14 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "config.h"
+
+// Headless simulation benchmark (--bench N): runs the simulation phases of
+// a tick (input, wave, AI, integrate, clamp, collision, sync) N times back
+// to back with scripted synthetic players, no sockets and no sleeping, and
+// prints ticks/s, per-phase ns/entity and a state checksum. The RNG seed is
+// fixed, so the same build and arguments give the same checksum.
+// Returns the process exit code.
+int bench_run(const ServerConfig* config);
+
+#endif
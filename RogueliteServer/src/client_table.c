@@ -0,0 +1,103 @@
+#include "client_table.h"
+#include "memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Keys only use the low 48 bits, so all-ones never collides with a real address
+#define CLIENT_TABLE_EMPTY UINT64_MAX
+
+static uint64_t make_key(const struct sockaddr_in* addr) {
+    // Both fields stay in network byte order; only equality matters
+    return ((uint64_t)addr->sin_addr.s_addr << 16) | (uint64_t)addr->sin_port;
+}
+
+// Fibonacci hashing spreads sequential ports/IPs across the table
+static size_t home_bucket(const ClientTable* table, uint64_t key) {
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (table->capacity - 1);
+}
+
+// Initialize table (load factor stays at or below 50%)
+void client_table_init(ClientTable* table, size_t max_entries) {
+    size_t capacity = 8;
+    while (capacity < max_entries * 2) {
+        capacity *= 2;
+    }
+    
+    table->keys = mem_alloc(capacity * sizeof(uint64_t));
+    table->slots = mem_alloc(capacity * sizeof(int));
+    
+    if (table->keys == NULL || table->slots == NULL) {
+        fprintf(stderr, "Failed to allocate client table!\n");
+        exit(1);
+    }
+    
+    for (size_t i = 0; i < capacity; i++) {
+        table->keys[i] = CLIENT_TABLE_EMPTY;
+    }
+    table->capacity = capacity;
+    table->count = 0;
+}
+
+// Free table
+void client_table_free(ClientTable* table) {
+    mem_free(table->keys);
+    mem_free(table->slots);
+    table->keys = NULL;
+    table->slots = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
+
+// Find slot for address
+int client_table_find(const ClientTable* table, const struct sockaddr_in* addr) {
+    uint64_t key = make_key(addr);
+    size_t mask = table->capacity - 1;
+    
+    for (size_t i = home_bucket(table, key); ; i = (i + 1) & mask) {
+        if (table->keys[i] == key) return table->slots[i];
+        if (table->keys[i] == CLIENT_TABLE_EMPTY) return -1;
+    }
+}
+
+// Insert address -> slot
+void client_table_insert(ClientTable* table, const struct sockaddr_in* addr, int slot) {
+    uint64_t key = make_key(addr);
+    size_t mask = table->capacity - 1;
+    
+    size_t i = home_bucket(table, key);
+    while (table->keys[i] != CLIENT_TABLE_EMPTY) {
+        i = (i + 1) & mask;
+    }
+    
+    table->keys[i] = key;
+    table->slots[i] = slot;
+    table->count++;
+}
+
+// Remove address, shifting later entries of the probe run back into the gap
+void client_table_remove(ClientTable* table, const struct sockaddr_in* addr) {
+    uint64_t key = make_key(addr);
+    size_t mask = table->capacity - 1;
+    
+    size_t i = home_bucket(table, key);
+    while (table->keys[i] != key) {
+        if (table->keys[i] == CLIENT_TABLE_EMPTY) return;  // Not present
+        i = (i + 1) & mask;
+    }
+    
+    size_t gap = i;
+    for (size_t j = (gap + 1) & mask; table->keys[j] != CLIENT_TABLE_EMPTY; j = (j + 1) & mask) {
+        // Entry j may move into the gap only if its home bucket is not in (gap, j]
+        size_t home = home_bucket(table, table->keys[j]);
+        bool home_in_range = (gap < j) ? (home > gap && home <= j)
+                                       : (home > gap || home <= j);
+        if (!home_in_range) {
+            table->keys[gap] = table->keys[j];
+            table->slots[gap] = table->slots[j];
+            gap = j;
+        }
+    }
+    
+    table->keys[gap] = CLIENT_TABLE_EMPTY;
+    table->count--;
+}
@@ -0,0 +1,31 @@
+#ifndef CLIENT_TABLE_H
+#define CLIENT_TABLE_H
+
+#include "udp_batch.h"   // sockaddr_in
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Open-addressing hash table: client address (IP, port) -> client slot.
+// Linear probing with backward-shift deletion, so there are no tombstones
+// and lookups stay short however often clients come and go.
+typedef struct {
+    uint64_t* keys;       // Packed (IP << 16 | port); CLIENT_TABLE_EMPTY when unused
+    int* slots;           // Client slot stored under each key
+    size_t capacity;      // Power of two, at least twice the client cap
+    size_t count;
+} ClientTable;
+
+void client_table_init(ClientTable* table, size_t max_entries);
+void client_table_free(ClientTable* table);
+
+// Slot for this address, or -1 if unknown
+int client_table_find(const ClientTable* table, const struct sockaddr_in* addr);
+
+// Add an address (must not already be present)
+void client_table_insert(ClientTable* table, const struct sockaddr_in* addr, int slot);
+
+// Remove an address if present
+void client_table_remove(ClientTable* table, const struct sockaddr_in* addr);
+
+#endif
@@ -1,17 +1,15 @@
 #include "collision.h"
 #include "game_loop.h"
-#include <stdio.h>
-
-// Entity sizes (in pixels)
-#define PLAYER_SIZE 32.0f
-#define ENEMY_SIZE 32.0f
-#define PROJECTILE_SIZE 8.0f
+#include "spatial_hash.h"
+#include "log.h"
+#include <stdint.h>
 
 // Get bounding box for entity
-BoundingBox collision_get_bounds(Entity* e) {
+BoundingBox collision_get_bounds(const EntityManager* em, const Entity* e) {
+    size_t i = entity_index(em, e);
     BoundingBox box;
-    box.x = e->position.x;
-    box.y = e->position.y;
+    box.x = em->pos_x[i];
+    box.y = em->pos_y[i];
     
     // Set size based on type
     switch (e->type) {
@@ -45,85 +43,95 @@ bool collision_check_aabb(BoundingBox a, BoundingBox b) {
 }
 
 // Check collision between two entities
-bool collision_check_entities(Entity* a, Entity* b) {
+bool collision_check_entities(const EntityManager* em, const Entity* a, const Entity* b) {
     if (!a->active || !b->active) return false;
     
-    BoundingBox box_a = collision_get_bounds(a);
-    BoundingBox box_b = collision_get_bounds(b);
+    BoundingBox box_a = collision_get_bounds(em, a);
+    BoundingBox box_b = collision_get_bounds(em, b);
     
     return collision_check_aabb(box_a, box_b);
 }
 
-// Resolve all collisions (UPDATED: tracks kills)
+// Resolve all collisions (UPDATED: projectiles come from the pool)
 void collision_resolve_all(void* game_ptr) {
     GameState* game = (GameState*)game_ptr;
     EntityManager* em = &game->entity_manager;
+    ProjectilePool* pool = &game->projectiles;
+    
+    // Broadphase: bucket every target by the 32px cells it overlaps
+    spatial_hash_build(&game->broadphase, em);
     
     // Check projectile collisions
-    for (size_t i = 0; i < em->count; i++) {
-        Entity* projectile = &em->entities[i];
+    for (size_t i = 0; i < pool->count; i++) {
+        if (!pool->active[i]) continue;
         
-        if (projectile->type != ENTITY_TYPE_PROJECTILE || !projectile->active) {
-            continue;
-        }
+        BoundingBox projectile_box;
+        projectile_box.x = pool->pos_x[i];
+        projectile_box.y = pool->pos_y[i];
+        projectile_box.width = PROJECTILE_SIZE;
+        projectile_box.height = PROJECTILE_SIZE;
+        uint32_t owner_id = pool->owner_id[i];
         
-        // Check against all non-projectile entities
-        for (size_t j = 0; j < em->count; j++) {
-            if (i == j) continue;
-            
-            Entity* target = &em->entities[j];
-            
-            // Skip projectiles and inactive entities
-            if (target->type == ENTITY_TYPE_PROJECTILE || !target->active) {
-                continue;
+        // Only test targets sharing a cell with the projectile. Keep the lowest
+        // index hit so results match a full scan in array order.
+        CellRange cells = spatial_hash_cells(projectile_box);
+        Entity* target = NULL;
+        uint32_t target_index = UINT32_MAX;
+        
+        for (int cy = cells.min_y; cy <= cells.max_y; cy++) {
+            for (int cx = cells.min_x; cx <= cells.max_x; cx++) {
+                size_t bucket_size;
+                const uint32_t* bucket = spatial_hash_bucket(&game->broadphase, cx, cy, &bucket_size);
+                
+                for (size_t b = 0; b < bucket_size; b++) {
+                    uint32_t j = bucket[b];
+                    if (j >= target_index) continue;  // Already have an earlier hit
+                    
+                    Entity* candidate = &em->entities[j];
+                    
+                    // Skip entities killed earlier this pass
+                    if (!candidate->active) continue;
+                    
+                    // CRITICAL: Skip if projectile would hit its owner
+                    if (owner_id == candidate->id) continue;
+                    
+                    if (collision_check_aabb(projectile_box, collision_get_bounds(em, candidate))) {
+                        target = candidate;
+                        target_index = j;
+                    }
+                }
             }
+        }
+        
+        if (target) {
+            // Hit!
+            target->health -= 10;
+            pool->active[i] = false;
             
-            // CRITICAL: Skip if projectile would hit its owner
-            if (projectile->owner_id == target->id) {
-                continue;
-            }
+            const char* target_type = (target->type == ENTITY_TYPE_PLAYER) ? "Player" : "Enemy";
+            LOG_DEBUG("Projectile %u hit %s %u! HP: %d\n", 
+                      pool->id[i], target_type, target->id, target->health);
             
-            // Check collision
-            if (collision_check_entities(projectile, target)) {
-                // Hit!
-                target->health -= 10;
-                projectile->active = false;
+            // Kill entity if health depleted
+            if (target->health <= 0) {
+                LOG_INFO("%s %u destroyed!\n", target_type, target->id);
+                target->active = false;
                 
-                const char* target_type = (target->type == ENTITY_TYPE_PLAYER) ? "Player" : "Enemy";
-                printf("Projectile %u hit %s %u! HP: %d\n", 
-                       projectile->id, target_type, target->id, target->health);
-                
-                // Kill entity if health depleted
-                if (target->health <= 0) {
-                    printf("%s %u destroyed!\n", target_type, target->id);
-                    target->active = false;
-                    
-                    // NEW: Track kills
-                    // Find who owns the projectile and increment their kills
-                    for (int k = 0; k < MAX_CLIENTS; k++) {
-                        if (game->clients[k].connected && 
-                            game->clients[k].player_id == projectile->owner_id) {
-                            game->clients[k].kills++;
-                            printf("Player %u now has %d kills!\n", 
-                                   projectile->owner_id, game->clients[k].kills);
-                            break;
-                        }
+                // NEW: Track kills
+                // Find who owns the projectile and increment their kills
+                for (int k = 0; k < game->config.max_clients; k++) {
+                    if (game->clients[k].connected && 
+                        game->clients[k].player_id == owner_id) {
+                        game->clients[k].kills++;
+                        LOG_INFO("Player %u now has %d kills!\n", 
+                                 owner_id, game->clients[k].kills);
+                        break;
                     }
                 }
-                
-                break;  // Projectile can only hit one entity
             }
         }
     }
     
-    // Remove inactive entities
-    for (size_t i = 0; i < em->count; ) {
-        if (!em->entities[i].active) {
-            // Swap with last and decrease count
-            em->entities[i] = em->entities[em->count - 1];
-            em->count--;
-        } else {
-            i++;
-        }
-    }
+    // Dead entities and spent projectiles are removed at the tick's sync point
+    // (entity_apply_commands / projectile_pool_compact), not here
 }
@@ -4,6 +4,10 @@
 #include "entity.h"
 #include <stdbool.h>
 
+// Entity sizes (in pixels; PROJECTILE_SIZE lives in projectile_pool.h)
+#define PLAYER_SIZE 32.0f
+#define ENEMY_SIZE 32.0f
+
 // AABB (Axis-Aligned Bounding Box) collision
 typedef struct {
     float x, y;      // Top-left corner
@@ -12,13 +16,13 @@ typedef struct {
 } BoundingBox;
 
 // Get bounding box for entity
-BoundingBox collision_get_bounds(Entity* e);
+BoundingBox collision_get_bounds(const EntityManager* em, const Entity* e);
 
 // Check if two boxes overlap
 bool collision_check_aabb(BoundingBox a, BoundingBox b);
 
 // Check collision between two entities
-bool collision_check_entities(Entity* a, Entity* b);
+bool collision_check_entities(const EntityManager* em, const Entity* a, const Entity* b);
 
 // Check and resolve all collisions in manager (needs GameState for kill tracking)
 void collision_resolve_all(void* game_state);
@@ -0,0 +1,155 @@
+#include "config.h"
+#include "worker_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_PORT 12345
+#define DEFAULT_PROJECTILE_CAPACITY 1024
+#define DEFAULT_TICK_RATE 60
+#define MAX_TICK_RATE 1000
+#define DEFAULT_MAX_CLIENTS 64
+#define DEFAULT_VIEW_RADIUS 1000  // Covers a 1280x720 screen around the player with margin
+#define DEFAULT_STATE_BUDGET 1200 // About one packet per client per tick (72 KB/s at 60 Hz)
+#define DEFAULT_PROFILE_INTERVAL 10
+#define MAX_PROFILE_INTERVAL 3600
+#define DEFAULT_AI_THREADS 1
+#define DEFAULT_BENCH_PLAYERS 32
+#define DEFAULT_BENCH_WAVES 3
+#define DEFAULT_BENCH_SEED 1      // Benchmarks are reproducible unless --seed says otherwise
+#define MAX_BENCH_PLAYERS 4096
+#define MAX_BENCH_WAVES 100
+
+void config_set_defaults(ServerConfig* config) {
+    config->port = DEFAULT_PORT;
+    config->projectile_capacity = DEFAULT_PROJECTILE_CAPACITY;
+    config->tick_rate = DEFAULT_TICK_RATE;
+    config->max_clients = DEFAULT_MAX_CLIENTS;
+    config->view_radius = DEFAULT_VIEW_RADIUS;
+    config->state_budget = DEFAULT_STATE_BUDGET;
+    config->profile_interval = DEFAULT_PROFILE_INTERVAL;
+    config->seed = 0;
+    config->ai_threads = DEFAULT_AI_THREADS;
+    config->bench_ticks = 0;
+    config->bench_players = DEFAULT_BENCH_PLAYERS;
+    config->bench_waves = DEFAULT_BENCH_WAVES;
+}
+
+static void print_usage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --port N              UDP port (default %d)\n", DEFAULT_PORT);
+    printf("  --projectiles N       Projectile pool capacity (default %d)\n", DEFAULT_PROJECTILE_CAPACITY);
+    printf("  --tick-rate N         Simulation ticks per second, 1-%d (default %d)\n",
+           MAX_TICK_RATE, DEFAULT_TICK_RATE);
+    printf("  --max-clients N       Concurrent clients, 1-%d (default %d)\n",
+           MAX_CLIENTS_LIMIT, DEFAULT_MAX_CLIENTS);
+    printf("  --view-radius N       Entity relevance radius around each player, px (default %d)\n",
+           DEFAULT_VIEW_RADIUS);
+    printf("  --state-budget N      STATE entity bytes per client per tick (default %d)\n",
+           DEFAULT_STATE_BUDGET);
+    printf("  --profile-interval N  Seconds between tick profile reports, 1-%d (default %d)\n",
+           MAX_PROFILE_INTERVAL, DEFAULT_PROFILE_INTERVAL);
+    printf("  --seed N              Simulation RNG seed (default: clock; %d with --bench)\n",
+           DEFAULT_BENCH_SEED);
+    printf("  --ai-threads N        Threads for enemy AI, 1-%d (default %d)\n",
+           WORKER_POOL_MAX_THREADS, DEFAULT_AI_THREADS);
+    printf("  --bench N             Run N ticks headless as fast as possible and report timings\n");
+    printf("  --bench-players N     Synthetic players in --bench, 1-%d (default %d)\n",
+           MAX_BENCH_PLAYERS, DEFAULT_BENCH_PLAYERS);
+    printf("  --bench-waves N       Waves started at once in --bench, 1-%d (default %d)\n",
+           MAX_BENCH_WAVES, DEFAULT_BENCH_WAVES);
+}
+
+// Parse a positive integer option value
+static bool parse_positive(const char* text, long* out) {
+    char* end;
+    long value = strtol(text, &end, 10);
+    if (*text == '\0' || *end != '\0' || value <= 0) return false;
+    *out = value;
+    return true;
+}
+
+bool config_parse_args(ServerConfig* config, int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        long value;
+
+        if (strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return false;
+        }
+
+        // Every option takes one value
+        if (i + 1 >= argc || !parse_positive(argv[i + 1], &value)) {
+            printf("Invalid or missing value for %s\n", arg);
+            print_usage(argv[0]);
+            return false;
+        }
+        i++;
+
+        if (strcmp(arg, "--port") == 0) {
+            if (value > 65535) {
+                printf("Port out of range: %ld\n", value);
+                return false;
+            }
+            config->port = (int)value;
+        } else if (strcmp(arg, "--projectiles") == 0) {
+            config->projectile_capacity = (size_t)value;
+        } else if (strcmp(arg, "--tick-rate") == 0) {
+            if (value > MAX_TICK_RATE) {
+                printf("Tick rate out of range: %ld\n", value);
+                return false;
+            }
+            config->tick_rate = (int)value;
+        } else if (strcmp(arg, "--max-clients") == 0) {
+            if (value > MAX_CLIENTS_LIMIT) {
+                printf("Max clients out of range: %ld\n", value);
+                return false;
+            }
+            config->max_clients = (int)value;
+        } else if (strcmp(arg, "--view-radius") == 0) {
+            config->view_radius = (float)value;
+        } else if (strcmp(arg, "--state-budget") == 0) {
+            config->state_budget = (int)value;
+        } else if (strcmp(arg, "--profile-interval") == 0) {
+            if (value > MAX_PROFILE_INTERVAL) {
+                printf("Profile interval out of range: %ld\n", value);
+                return false;
+            }
+            config->profile_interval = (int)value;
+        } else if (strcmp(arg, "--seed") == 0) {
+            config->seed = (unsigned int)value;
+        } else if (strcmp(arg, "--ai-threads") == 0) {
+            if (value > WORKER_POOL_MAX_THREADS) {
+                printf("AI threads out of range: %ld\n", value);
+                return false;
+            }
+            config->ai_threads = (int)value;
+        } else if (strcmp(arg, "--bench") == 0) {
+            config->bench_ticks = (int)value;
+        } else if (strcmp(arg, "--bench-players") == 0) {
+            if (value > MAX_BENCH_PLAYERS) {
+                printf("Bench players out of range: %ld\n", value);
+                return false;
+            }
+            config->bench_players = (int)value;
+        } else if (strcmp(arg, "--bench-waves") == 0) {
+            if (value > MAX_BENCH_WAVES) {
+                printf("Bench waves out of range: %ld\n", value);
+                return false;
+            }
+            config->bench_waves = (int)value;
+        } else {
+            printf("Unknown option: %s\n", arg);
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+
+    // Benchmarks default to a fixed seed so runs compare
+    if (config->bench_ticks > 0 && config->seed == 0) {
+        config->seed = DEFAULT_BENCH_SEED;
+    }
+
+    return true;
+}
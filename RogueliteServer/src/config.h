@@ -0,0 +1,34 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Upper bound for --max-clients
+#define MAX_CLIENTS_LIMIT 256
+
+// Server configuration (defaults, overridable from the command line)
+typedef struct {
+    int port;                      // UDP port to bind
+    size_t projectile_capacity;    // Fixed size of the projectile pool
+    int tick_rate;                 // Simulation ticks per second (e.g. 30, 60, 128)
+    int max_clients;               // Concurrent client sessions (players, bots, spectators)
+    float view_radius;             // Entities further than this from a client's player aren't sent
+    int state_budget;              // STATE entity bytes per client per tick (highest priority first)
+    int profile_interval;          // Seconds between tick profile reports
+    unsigned int seed;             // Simulation RNG seed (0 = seed from the clock)
+    int ai_threads;                // Threads for the enemy AI decision phase (1 = tick thread only)
+    
+    // Headless benchmark (--bench): no sockets, no sleeping
+    int bench_ticks;               // 0 = normal networked server
+    int bench_players;             // Synthetic players driven by scripted input
+    int bench_waves;               // Waves started up front
+} ServerConfig;
+
+// Fill in defaults
+void config_set_defaults(ServerConfig* config);
+
+// Parse "--option value" arguments; prints usage and returns false on error
+bool config_parse_args(ServerConfig* config, int argc, char** argv);
+
+#endif
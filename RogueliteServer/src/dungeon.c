@@ -0,0 +1,245 @@
+#include "dungeon.h"
+#include "memory.h"
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Generation mirrors World/DungeonGenerator.cs and BSPNode.cs step for step:
+// every random draw happens in the same order with the same bounds, so
+// the client rebuilds the identical map from the seed.
+
+typedef struct {
+    int x, y, w, h;             // Partition (tiles)
+    int left, right;            // Child node indices (-1 for a leaf)
+    int room_x, room_y, room_w, room_h;
+} BspNode;
+
+typedef struct {
+    BspNode* nodes;
+    int count;
+} BspTree;
+
+static int bsp_add(BspTree* tree, int x, int y, int w, int h) {
+    BspNode* node = &tree->nodes[tree->count];
+    node->x = x;
+    node->y = y;
+    node->w = w;
+    node->h = h;
+    node->left = -1;
+    node->right = -1;
+    node->room_w = 0;
+    return tree->count++;
+}
+
+// BSPNode.Split
+static void bsp_split(BspTree* tree, int index, Rng* rng) {
+    BspNode node = tree->nodes[index];
+    if (node.w < DUNGEON_MIN_LEAF * 2 || node.h < DUNGEON_MIN_LEAF * 2) return;
+
+    // Cut across the longer side (random if square)
+    bool horizontal = node.w > node.h ? false
+                    : node.h > node.w ? true
+                    : rng_int(rng, 0, 2) == 0;
+
+    int left, right;
+    if (horizontal) {
+        int split = rng_int(rng, DUNGEON_MIN_LEAF, node.h - DUNGEON_MIN_LEAF);
+        left = bsp_add(tree, node.x, node.y, node.w, split);
+        right = bsp_add(tree, node.x, node.y + split, node.w, node.h - split);
+    } else {
+        int split = rng_int(rng, DUNGEON_MIN_LEAF, node.w - DUNGEON_MIN_LEAF);
+        left = bsp_add(tree, node.x, node.y, split, node.h);
+        right = bsp_add(tree, node.x + split, node.y, node.w - split, node.h);
+    }
+    tree->nodes[index].left = left;
+    tree->nodes[index].right = right;
+
+    bsp_split(tree, left, rng);
+    bsp_split(tree, right, rng);
+}
+
+// BSPNode.CreateRooms: one room per leaf, at least a tile inside its partition
+static void bsp_create_rooms(BspTree* tree, int index, Rng* rng) {
+    BspNode* node = &tree->nodes[index];
+    if (node->left < 0) {
+        int max_w = node->w - 2 < DUNGEON_MAX_ROOM ? node->w - 2 : DUNGEON_MAX_ROOM;
+        int max_h = node->h - 2 < DUNGEON_MAX_ROOM ? node->h - 2 : DUNGEON_MAX_ROOM;
+        node->room_w = rng_int(rng, DUNGEON_MIN_ROOM, max_w);
+        node->room_h = rng_int(rng, DUNGEON_MIN_ROOM, max_h);
+        node->room_x = node->x + rng_int(rng, 1, node->w - node->room_w - 1);
+        node->room_y = node->y + rng_int(rng, 1, node->h - node->room_h - 1);
+        return;
+    }
+    bsp_create_rooms(tree, node->left, rng);
+    bsp_create_rooms(tree, node->right, rng);
+}
+
+// BSPNode.GetRoom: a leaf's room, or a random one from below
+static const BspNode* bsp_get_room(const BspTree* tree, int index, Rng* rng) {
+    const BspNode* node = &tree->nodes[index];
+    if (node->left < 0) return node;
+
+    const BspNode* left = bsp_get_room(tree, node->left, rng);
+    const BspNode* right = bsp_get_room(tree, node->right, rng);
+    return rng_int(rng, 0, 2) == 0 ? left : right;
+}
+
+static void set_floor(Dungeon* dungeon, int tx, int ty) {
+    if (tx < 0 || ty < 0 || tx >= dungeon->width || ty >= dungeon->height) return;
+    dungeon->floor[(size_t)ty * dungeon->words_per_row + (size_t)(tx >> 6)] |= 1ull << (tx & 63);
+}
+
+static void carve_rooms(Dungeon* dungeon, const BspTree* tree) {
+    for (int i = 0; i < tree->count; i++) {
+        const BspNode* node = &tree->nodes[i];
+        if (node->left >= 0) continue;
+        for (int y = node->room_y; y < node->room_y + node->room_h; y++) {
+            for (int x = node->room_x; x < node->room_x + node->room_w; x++) {
+                set_floor(dungeon, x, y);
+            }
+        }
+    }
+}
+
+// 3-wide corridors between room centers
+static void carve_horizontal(Dungeon* dungeon, int x1, int x2, int y) {
+    int start = x1 < x2 ? x1 : x2;
+    int end = x1 < x2 ? x2 : x1;
+    for (int x = start; x <= end; x++) {
+        set_floor(dungeon, x, y - 1);
+        set_floor(dungeon, x, y);
+        set_floor(dungeon, x, y + 1);
+    }
+}
+
+static void carve_vertical(Dungeon* dungeon, int x, int y1, int y2) {
+    int start = y1 < y2 ? y1 : y2;
+    int end = y1 < y2 ? y2 : y1;
+    for (int y = start; y <= end; y++) {
+        set_floor(dungeon, x - 1, y);
+        set_floor(dungeon, x, y);
+        set_floor(dungeon, x + 1, y);
+    }
+}
+
+// DungeonGenerator.ConnectRooms: an L-shaped corridor between a room on
+// each side of every split
+static void connect_rooms(Dungeon* dungeon, const BspTree* tree, int index, Rng* rng) {
+    const BspNode* node = &tree->nodes[index];
+    if (node->left < 0) return;
+
+    const BspNode* a = bsp_get_room(tree, node->left, rng);
+    const BspNode* b = bsp_get_room(tree, node->right, rng);
+    int ax = a->room_x + a->room_w / 2, ay = a->room_y + a->room_h / 2;
+    int bx = b->room_x + b->room_w / 2, by = b->room_y + b->room_h / 2;
+
+    if (rng_int(rng, 0, 2) == 0) {
+        carve_horizontal(dungeon, ax, bx, ay);
+        carve_vertical(dungeon, bx, ay, by);
+    } else {
+        carve_vertical(dungeon, ax, ay, by);
+        carve_horizontal(dungeon, ax, bx, by);
+    }
+
+    connect_rooms(dungeon, tree, node->left, rng);
+    connect_rooms(dungeon, tree, node->right, rng);
+}
+
+void dungeon_generate(Dungeon* dungeon, uint32_t seed, int width, int height,
+                      float origin_x, float origin_y) {
+    dungeon->width = width;
+    dungeon->height = height;
+    dungeon->origin_x = origin_x;
+    dungeon->origin_y = origin_y;
+    dungeon->seed = seed;
+    dungeon->words_per_row = ((size_t)width + 63) / 64;
+
+    // Every partition is at least MIN_LEAF square, which bounds the leaf count
+    int max_leaves = (width / DUNGEON_MIN_LEAF) * (height / DUNGEON_MIN_LEAF) + 1;
+    BspTree tree;
+    tree.count = 0;
+    tree.nodes = mem_alloc((size_t)(2 * max_leaves) * sizeof(BspNode));
+    dungeon->floor = mem_alloc((size_t)height * dungeon->words_per_row * sizeof(uint64_t));
+    if (tree.nodes == NULL || dungeon->floor == NULL) {
+        fprintf(stderr, "Failed to allocate dungeon!\n");
+        exit(1);
+    }
+    memset(dungeon->floor, 0, (size_t)height * dungeon->words_per_row * sizeof(uint64_t));  // All wall
+
+    Rng rng;
+    rng_seed(&rng, seed, 0);
+    bsp_add(&tree, 0, 0, width, height);
+    bsp_split(&tree, 0, &rng);
+    bsp_create_rooms(&tree, 0, &rng);
+    carve_rooms(dungeon, &tree);
+    connect_rooms(dungeon, &tree, 0, &rng);
+
+    mem_free(tree.nodes);
+}
+
+void dungeon_free(Dungeon* dungeon) {
+    mem_free(dungeon->floor);
+    dungeon->floor = NULL;
+    dungeon->width = 0;
+    dungeon->height = 0;
+}
+
+int dungeon_tile_x(const Dungeon* dungeon, float x) {
+    return (int)floorf((x - dungeon->origin_x) / DUNGEON_TILE_SIZE);
+}
+
+int dungeon_tile_y(const Dungeon* dungeon, float y) {
+    return (int)floorf((y - dungeon->origin_y) / DUNGEON_TILE_SIZE);
+}
+
+bool dungeon_walkable_at(const Dungeon* dungeon, float x, float y) {
+    return dungeon_tile_walkable(dungeon, dungeon_tile_x(dungeon, x), dungeon_tile_y(dungeon, y));
+}
+
+static bool open_area(const Dungeon* dungeon, int tx, int ty) {
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (!dungeon_tile_walkable(dungeon, tx + dx, ty + dy)) return false;
+        }
+    }
+    return true;
+}
+
+static Vector2 tile_corner(const Dungeon* dungeon, int tx, int ty) {
+    return vector2_create(dungeon->origin_x + (float)(tx * DUNGEON_TILE_SIZE),
+                          dungeon->origin_y + (float)(ty * DUNGEON_TILE_SIZE));
+}
+
+Vector2 dungeon_random_spawn(const Dungeon* dungeon, Rng* rng) {
+    for (int attempt = 0; attempt < 1000; attempt++) {
+        int tx = rng_int(rng, 1, dungeon->width - 1);
+        int ty = rng_int(rng, 1, dungeon->height - 1);
+        if (open_area(dungeon, tx, ty)) return tile_corner(dungeon, tx, ty);
+    }
+
+    // Unlucky (or cramped): take the first open spot
+    LOG_WARN("Searching entire dungeon for a safe spawn...\n");
+    for (int ty = 1; ty < dungeon->height - 1; ty++) {
+        for (int tx = 1; tx < dungeon->width - 1; tx++) {
+            if (open_area(dungeon, tx, ty)) return tile_corner(dungeon, tx, ty);
+        }
+    }
+
+    LOG_ERROR("No safe spawn in the dungeon, using its center\n");
+    return tile_corner(dungeon, dungeon->width / 2, dungeon->height / 2);
+}
+
+int dungeon_floor_count(const Dungeon* dungeon) {
+    int count = 0;
+    size_t words = (size_t)dungeon->height * dungeon->words_per_row;
+    for (size_t i = 0; i < words; i++) {
+#if defined(__GNUC__)
+        count += __builtin_popcountll(dungeon->floor[i]);
+#else
+        for (uint64_t w = dungeon->floor[i]; w != 0; w &= w - 1) count++;
+#endif
+    }
+    return count;
+}
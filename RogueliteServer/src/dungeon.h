@@ -0,0 +1,51 @@
+#ifndef DUNGEON_H
+#define DUNGEON_H
+
+#include "vector2.h"
+#include "rng.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// BSP dungeon, generated from a seed by the same algorithm as the client's
+// World/DungeonGenerator.cs, so only the seed goes over the wire.
+// Walkability is a packed bitmap: 1 bit per tile (set = floor), each row
+// padded to whole 64-bit words, so a 50x37 map is 296 bytes.
+#define DUNGEON_TILE_SIZE 32
+#define DUNGEON_MIN_LEAF 8          // BSP partitions are at least this many tiles across
+#define DUNGEON_MIN_ROOM 4
+#define DUNGEON_MAX_ROOM 10
+
+typedef struct {
+    int width, height;          // Tiles
+    float origin_x, origin_y;   // World position of tile (0, 0)'s top-left corner
+    uint32_t seed;
+    size_t words_per_row;
+    uint64_t* floor;            // height * words_per_row words
+} Dungeon;
+
+// Generate a width x height tile dungeon whose tile (0, 0) starts at (origin_x, origin_y)
+void dungeon_generate(Dungeon* dungeon, uint32_t seed, int width, int height,
+                      float origin_x, float origin_y);
+void dungeon_free(Dungeon* dungeon);
+
+// Outside the map counts as wall
+static inline bool dungeon_tile_walkable(const Dungeon* dungeon, int tx, int ty) {
+    if (tx < 0 || ty < 0 || tx >= dungeon->width || ty >= dungeon->height) return false;
+    uint64_t word = dungeon->floor[(size_t)ty * dungeon->words_per_row + (size_t)(tx >> 6)];
+    return (word >> (tx & 63)) & 1u;
+}
+
+// Tile containing a world position (may be outside the map)
+int dungeon_tile_x(const Dungeon* dungeon, float x);
+int dungeon_tile_y(const Dungeon* dungeon, float y);
+
+bool dungeon_walkable_at(const Dungeon* dungeon, float x, float y);
+
+// Top-left corner of a random floor tile whose 8 neighbours are floor too,
+// so a 32px entity placed there starts clear of walls
+Vector2 dungeon_random_spawn(const Dungeon* dungeon, Rng* rng);
+
+int dungeon_floor_count(const Dungeon* dungeon);
+
+#endif
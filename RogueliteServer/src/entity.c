@@ -1,74 +1,141 @@
 #include "entity.h"
+#include "memory.h"
+#include "log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Resize every hot/cold array to 'capacity' (returns false if any realloc fails)
+static bool entity_arrays_resize(EntityManager* em, size_t capacity) {
+    float* pos_x = mem_realloc(em->pos_x, capacity * sizeof(float));
+    if (pos_x == NULL) return false;
+    em->pos_x = pos_x;
+    
+    float* pos_y = mem_realloc(em->pos_y, capacity * sizeof(float));
+    if (pos_y == NULL) return false;
+    em->pos_y = pos_y;
+    
+    float* vel_x = mem_realloc(em->vel_x, capacity * sizeof(float));
+    if (vel_x == NULL) return false;
+    em->vel_x = vel_x;
+    
+    float* vel_y = mem_realloc(em->vel_y, capacity * sizeof(float));
+    if (vel_y == NULL) return false;
+    em->vel_y = vel_y;
+    
+    Entity* entities = mem_realloc(em->entities, capacity * sizeof(Entity));
+    if (entities == NULL) return false;
+    em->entities = entities;
+    
+    AIComponent* ai = mem_realloc(em->ai, capacity * sizeof(AIComponent));
+    if (ai == NULL) return false;
+    em->ai = ai;
+    
+    em->capacity = capacity;
+    return true;
+}
+
 // Initialize entity manager
 void entity_manager_init(EntityManager* em, size_t initial_capacity) {
-    // Allocate array on HEAP
-    em->entities = malloc(initial_capacity * sizeof(Entity));
+    em->pos_x = NULL;
+    em->pos_y = NULL;
+    em->vel_x = NULL;
+    em->vel_y = NULL;
+    em->entities = NULL;
+    em->ai = NULL;
+    em->capacity = 0;
     
-    if (em->entities == NULL) {
+    // Allocate arrays on HEAP
+    if (!entity_arrays_resize(em, initial_capacity)) {
         fprintf(stderr, "Failed to allocate memory for entities!\n");
         exit(1);  // Exit if allocation fails
     }
     
     em->count = 0;
-    em->capacity = initial_capacity;
-    em->next_id = 1;  // Start IDs at 1 (0 = invalid)
+    handle_table_init(&em->handles, initial_capacity, 0);  // IDs are never 0 (0 = invalid)
+    
+    // Command buffers (grow on demand, never shrink)
+    em->spawn_capacity = 16;
+    em->spawn_count = 0;
+    em->spawn_queue = mem_alloc(em->spawn_capacity * sizeof(SpawnCommand));
+    em->despawn_capacity = 16;
+    em->despawn_count = 0;
+    em->despawn_queue = mem_alloc(em->despawn_capacity * sizeof(uint32_t));
     
-    printf("EntityManager initialized with capacity %zu\n", initial_capacity);
+    if (em->spawn_queue == NULL || em->despawn_queue == NULL) {
+        fprintf(stderr, "Failed to allocate entity command buffers!\n");
+        exit(1);
+    }
+    
+    LOG_INFO("EntityManager initialized with capacity %zu\n", initial_capacity);
 }
 
 // Free entity manager
 void entity_manager_free(EntityManager* em) {
-    free(em->entities);  // Free the array
+    mem_free(em->pos_x);
+    mem_free(em->pos_y);
+    mem_free(em->vel_x);
+    mem_free(em->vel_y);
+    mem_free(em->entities);
+    mem_free(em->ai);
+    handle_table_free(&em->handles);
+    mem_free(em->spawn_queue);
+    mem_free(em->despawn_queue);
+    em->spawn_queue = NULL;
+    em->despawn_queue = NULL;
+    em->spawn_count = 0;
+    em->despawn_count = 0;
+    em->pos_x = NULL;
+    em->pos_y = NULL;
+    em->vel_x = NULL;
+    em->vel_y = NULL;
     em->entities = NULL;
+    em->ai = NULL;
     em->count = 0;
     em->capacity = 0;
     
-    printf("EntityManager freed\n");
+    LOG_INFO("EntityManager freed\n");
 }
 
-// Create new entity
-Entity* entity_create(EntityManager* em, EntityType type, Vector2 position) {
-    // Check if we need to grow the array
-    if (em->count >= em->capacity) {
-        // Double the capacity
-        size_t new_capacity = em->capacity * 2;
-        
-        printf("Growing entity array: %zu -> %zu\n", em->capacity, new_capacity);
-        
-        // Reallocate (resize) the array
-        Entity* new_entities = realloc(em->entities, new_capacity * sizeof(Entity));
-        
-        if (new_entities == NULL) {
-            fprintf(stderr, "Failed to grow entity array!\n");
-            return NULL;
-        }
-        
-        em->entities = new_entities;
-        em->capacity = new_capacity;
-    }
+// Make room for one more entity (doubling); false if realloc fails
+static bool entity_reserve_one(EntityManager* em) {
+    if (em->count < em->capacity) return true;
     
-    // Get pointer to next available slot
-    Entity* e = &em->entities[em->count];
-    em->count++;
+    // Double the capacity
+    size_t new_capacity = em->capacity * 2;
     
-    // Initialize entity
-    e->id = em->next_id++;
+    LOG_INFO("Growing entity array: %zu -> %zu\n", em->capacity, new_capacity);
+    
+    if (!entity_arrays_resize(em, new_capacity)) {
+        fprintf(stderr, "Failed to grow entity array!\n");
+        return false;
+    }
+    return true;
+}
+
+// Fill slot i with a fresh entity of the given type
+static Entity* entity_init_slot(EntityManager* em, size_t i, uint32_t id,
+                                EntityType type, Vector2 position) {
+    // Hot data
+    em->pos_x[i] = position.x;
+    em->pos_y[i] = position.y;
+    em->vel_x[i] = 0.0f;
+    em->vel_y[i] = 0.0f;
+    
+    // Cold data
+    Entity* e = &em->entities[i];
+    e->id = id;
     e->type = type;
-    e->position = position;
-    e->velocity = vector2_create(0.0f, 0.0f);
     e->active = true;
     e->owner_id = 0;  // Default: no owner
-    e->rotation = 0.0f;  // NEW: Start facing right
+    e->rotation = 0.0f;  // Start facing right
     
     // Initialize AI component
-    e->ai.state = AI_STATE_IDLE;
-    e->ai.state_timer = 0.0f;
-    e->ai.attack_cooldown = 0.0f;
-    e->ai.wander_target = position;
+    AIComponent* ai = &em->ai[i];
+    ai->state = AI_STATE_IDLE;
+    ai->state_timer = 0.0f;
+    ai->attack_cooldown = 0.0f;
+    ai->wander_target = position;
 
     // Set health based on type
     if (type == ENTITY_TYPE_PLAYER) {
@@ -82,62 +149,170 @@ Entity* entity_create(EntityManager* em, EntityType type, Vector2 position) {
         e->max_health = 1;
     }
     
-    printf("Created entity ID %u (type %d) at ", e->id, e->type);
-    vector2_print(e->position);
-    printf("\n");
+    LOG_DEBUG("Created entity ID %u (type %d) at (%.2f, %.2f)\n", e->id, e->type, position.x, position.y);
     
     return e;
 }
 
-// Destroy entity by ID
-void entity_destroy(EntityManager* em, uint32_t id) {
-    for (size_t i = 0; i < em->count; i++) {
-        if (em->entities[i].id == id) {
-            printf("Destroying entity ID %u\n", id);
-            
-            // Swap with last entity (fast removal)
-            em->entities[i] = em->entities[em->count - 1];
-            em->count--;
-            
-            return;
+// Create new entity immediately
+Entity* entity_create(EntityManager* em, EntityType type, Vector2 position) {
+    if (!entity_reserve_one(em)) return NULL;
+    
+    // Claim next available slot and an ID pointing at it
+    size_t i = em->count;
+    uint32_t id = handle_alloc(&em->handles, (uint32_t)i);
+    if (id == HANDLE_INVALID) {
+        fprintf(stderr, "Out of entity IDs!\n");
+        return NULL;
+    }
+    em->count++;
+    
+    return entity_init_slot(em, i, id, type, position);
+}
+
+// Queue an entity for creation at the next sync point
+uint32_t entity_spawn(EntityManager* em, EntityType type, Vector2 position,
+                      Vector2 velocity, uint32_t owner_id, float rotation) {
+    // Reserve the ID now; it stays pending (unresolvable) until applied
+    uint32_t id = handle_alloc(&em->handles, HANDLE_NO_DENSE);
+    if (id == HANDLE_INVALID) {
+        fprintf(stderr, "Out of entity IDs!\n");
+        return HANDLE_INVALID;
+    }
+    
+    if (em->spawn_count >= em->spawn_capacity) {
+        size_t new_capacity = em->spawn_capacity * 2;
+        SpawnCommand* queue = mem_realloc(em->spawn_queue, new_capacity * sizeof(SpawnCommand));
+        if (queue == NULL) {
+            fprintf(stderr, "Failed to grow spawn queue!\n");
+            handle_release(&em->handles, id);
+            return HANDLE_INVALID;
         }
+        em->spawn_queue = queue;
+        em->spawn_capacity = new_capacity;
     }
     
-    printf("Entity ID %u not found\n", id);
+    SpawnCommand* cmd = &em->spawn_queue[em->spawn_count++];
+    cmd->id = id;
+    cmd->type = type;
+    cmd->position = position;
+    cmd->velocity = velocity;
+    cmd->owner_id = owner_id;
+    cmd->rotation = rotation;
+    
+    return id;
 }
 
-// Get entity by ID
-Entity* entity_get_by_id(EntityManager* em, uint32_t id) {
-    for (size_t i = 0; i < em->count; i++) {
-        if (em->entities[i].id == id) {
-            return &em->entities[i];
+// Queue an entity for destruction at the next sync point
+void entity_despawn(EntityManager* em, uint32_t id) {
+    if (em->despawn_count >= em->despawn_capacity) {
+        size_t new_capacity = em->despawn_capacity * 2;
+        uint32_t* queue = mem_realloc(em->despawn_queue, new_capacity * sizeof(uint32_t));
+        if (queue == NULL) {
+            fprintf(stderr, "Failed to grow despawn queue!\n");
+            return;
         }
+        em->despawn_queue = queue;
+        em->despawn_capacity = new_capacity;
     }
-    return NULL;  // Not found
+    
+    em->despawn_queue[em->despawn_count++] = id;
 }
 
-// Update all entities, added projectile cleanup:
-void entity_update_all(EntityManager* em, float delta_time) {
-    for (size_t i = 0; i < em->count; i++) {
-        Entity* e = &em->entities[i];
+// Apply queued commands and compact (the only place entities are removed)
+void entity_apply_commands(EntityManager* em) {
+    // 1. Append spawns (arrays may grow here: nobody holds an Entity* now)
+    for (size_t s = 0; s < em->spawn_count; s++) {
+        SpawnCommand* cmd = &em->spawn_queue[s];
+        
+        if (!entity_reserve_one(em)) {
+            handle_release(&em->handles, cmd->id);
+            continue;
+        }
         
-        if (!e->active) continue;
+        size_t i = em->count++;
+        handle_set_dense(&em->handles, cmd->id, (uint32_t)i);
         
-        // Update position
-        e->position.x += e->velocity.x * delta_time;
-        e->position.y += e->velocity.y * delta_time;
+        Entity* e = entity_init_slot(em, i, cmd->id, cmd->type, cmd->position);
+        em->vel_x[i] = cmd->velocity.x;
+        em->vel_y[i] = cmd->velocity.y;
+        e->owner_id = cmd->owner_id;
+        e->rotation = cmd->rotation;
+    }
+    em->spawn_count = 0;
+    
+    // 2. Despawns just mark inactive; stale IDs are ignored
+    for (size_t d = 0; d < em->despawn_count; d++) {
+        Entity* e = entity_get_by_id(em, em->despawn_queue[d]);
+        if (e) {
+            LOG_DEBUG("Destroying entity ID %u\n", e->id);
+            e->active = false;
+        }
+    }
+    em->despawn_count = 0;
+    
+    // 3. One stable sweep: slide survivors down, release IDs of the rest
+    size_t write = 0;
+    for (size_t read = 0; read < em->count; read++) {
+        if (!em->entities[read].active) {
+            handle_release(&em->handles, em->entities[read].id);
+            continue;
+        }
         
-        // NEW: Remove projectiles that go off map boundaries
-        if (e->type == ENTITY_TYPE_PROJECTILE) {
-            // Check against map boundaries
-            if (e->position.x < -400 || e->position.x > 1200 ||
-                e->position.y < -300 || e->position.y > 900) {
-                e->active = false;
-                printf("Projectile %u hit boundary, removed\n", e->id);
-            }
+        if (write != read) {
+            em->pos_x[write] = em->pos_x[read];
+            em->pos_y[write] = em->pos_y[read];
+            em->vel_x[write] = em->vel_x[read];
+            em->vel_y[write] = em->vel_y[read];
+            em->entities[write] = em->entities[read];
+            em->ai[write] = em->ai[read];
+            handle_set_dense(&em->handles, em->entities[write].id, (uint32_t)write);
         }
+        write++;
+    }
+    em->count = write;
+}
+
+// Get entity by ID (O(1); stale IDs of destroyed entities return NULL)
+Entity* entity_get_by_id(EntityManager* em, uint32_t id) {
+    uint32_t index;
+    if (!handle_lookup(&em->handles, id, &index)) {
+        return NULL;  // Not found
     }
+    return &em->entities[index];
 }
+
+// pos[i] += vel[i] * dt over one axis (restrict params let the compiler vectorize)
+static void integrate_axis(float* restrict pos, const float* restrict vel, size_t count, float delta_time) {
+    for (size_t i = 0; i < count; i++) {
+        pos[i] += vel[i] * delta_time;
+    }
+}
+
+// Clamp one axis to [min, max], zeroing velocity where clamped (branch-free)
+static void clamp_axis(float* restrict pos, float* restrict vel, size_t count, float min, float max) {
+    for (size_t i = 0; i < count; i++) {
+        float p = pos[i];
+        float c = p < min ? min : (p > max ? max : p);
+        vel[i] = (c != p) ? 0.0f : vel[i];
+        pos[i] = c;
+    }
+}
+
+// Update all entities (projectiles live in ProjectilePool and move there)
+void entity_update_all(EntityManager* em, float delta_time) {
+    // Integrate positions as straight passes over dense floats.
+    // Inactive entities move too; they are compacted away before anyone reads them.
+    integrate_axis(em->pos_x, em->vel_x, em->count, delta_time);
+    integrate_axis(em->pos_y, em->vel_y, em->count, delta_time);
+}
+
+// Clamp every entity to the given bounds, zeroing velocity on the clamped axis
+void entity_clamp_all(EntityManager* em, float min_x, float min_y, float max_x, float max_y) {
+    clamp_axis(em->pos_x, em->vel_x, em->count, min_x, max_x);
+    clamp_axis(em->pos_y, em->vel_y, em->count, min_y, max_y);
+}
+
 // Print all entities
 void entity_print_all(EntityManager* em) {
     printf("\n=== ENTITIES (%zu/%zu) ===\n", em->count, em->capacity);
@@ -148,7 +323,7 @@ void entity_print_all(EntityManager* em) {
         printf("ID %u [%s] at ", e->id, 
                e->type == ENTITY_TYPE_PLAYER ? "PLAYER" :
                e->type == ENTITY_TYPE_ENEMY ? "ENEMY" : "PROJECTILE");
-        vector2_print(e->position);
+        vector2_print(entity_get_position(em, e));
         printf(" HP: %d/%d\n", e->health, e->max_health);
     }
     
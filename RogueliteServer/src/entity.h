@@ -2,6 +2,7 @@
 #define ENTITY_H
 
 #include "vector2.h"
+#include "handle_table.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>  // For size_t
@@ -29,35 +30,110 @@ typedef struct {
     Vector2 wander_target;
 } AIComponent;
 
-// Single entity (UPDATED - added ai field)
+// Cold per-entity data (UPDATED - position/velocity moved to hot arrays)
+// Everything the integrate and clamp passes never touch lives here.
 typedef struct {
-    uint32_t id;
+    uint32_t id;     // Generational handle (slot + generation), never reused while alive
     EntityType type;
-    Vector2 position;
-    Vector2 velocity;
     int health;
     int max_health;
     bool active;
-    AIComponent ai;  
     uint32_t owner_id;
-    float rotation;  // NEW: Rotation angle in radians (0 = right, PI/2 = down)
+    float rotation;  // Rotation angle in radians (0 = right, PI/2 = down)
 } Entity;
 
-// Entity manager
+// Queued spawn, applied at the next entity_apply_commands
 typedef struct {
+    uint32_t id;          // Reserved when queued, so callers can record it immediately
+    EntityType type;
+    Vector2 position;
+    Vector2 velocity;
+    uint32_t owner_id;
+    float rotation;
+} SpawnCommand;
+
+// Entity manager (structure-of-arrays)
+// Index i in every array below belongs to the same entity.
+typedef struct {
+    // Hot: streamed every tick by entity_update_all / entity_clamp_all
+    float* pos_x;
+    float* pos_y;
+    float* vel_x;
+    float* vel_y;
+    
+    // Cold: id/type/health/network fields, and AI state
     Entity* entities;
+    AIComponent* ai;
+    
     size_t count;
     size_t capacity;
-    uint32_t next_id;
+    
+    // Sparse index: entity ID (handle) -> dense index above
+    HandleTable handles;
+    
+    // Command buffers: spawns/despawns requested during a tick.
+    // The arrays above never grow or reorder until entity_apply_commands.
+    SpawnCommand* spawn_queue;
+    size_t spawn_count;
+    size_t spawn_capacity;
+    uint32_t* despawn_queue;
+    size_t despawn_count;
+    size_t despawn_capacity;
 } EntityManager;
 
+// Accessor layer: lets Entity*-based code reach the hot/cold arrays.
+// 'e' must point into em->entities.
+static inline size_t entity_index(const EntityManager* em, const Entity* e) {
+    return (size_t)(e - em->entities);
+}
+
+static inline Vector2 entity_get_position(const EntityManager* em, const Entity* e) {
+    size_t i = entity_index(em, e);
+    return vector2_create(em->pos_x[i], em->pos_y[i]);
+}
+
+static inline void entity_set_position(EntityManager* em, const Entity* e, Vector2 position) {
+    size_t i = entity_index(em, e);
+    em->pos_x[i] = position.x;
+    em->pos_y[i] = position.y;
+}
+
+static inline Vector2 entity_get_velocity(const EntityManager* em, const Entity* e) {
+    size_t i = entity_index(em, e);
+    return vector2_create(em->vel_x[i], em->vel_y[i]);
+}
+
+static inline void entity_set_velocity(EntityManager* em, const Entity* e, Vector2 velocity) {
+    size_t i = entity_index(em, e);
+    em->vel_x[i] = velocity.x;
+    em->vel_y[i] = velocity.y;
+}
+
+static inline AIComponent* entity_get_ai(EntityManager* em, const Entity* e) {
+    return &em->ai[entity_index(em, e)];
+}
+
 // Function declarations
 void entity_manager_init(EntityManager* em, size_t initial_capacity);
 void entity_manager_free(EntityManager* em);
+
+// Immediate creation: only for setup code that holds no Entity* (may realloc)
 Entity* entity_create(EntityManager* em, EntityType type, Vector2 position);
-void entity_destroy(EntityManager* em, uint32_t id);
-Entity* entity_get_by_id(EntityManager* em, uint32_t id);
+
+// Deferred creation/destruction: safe while iterating; takes effect at the sync point.
+// entity_spawn returns the new entity's ID (0 if out of IDs); it resolves
+// through entity_get_by_id only after the next entity_apply_commands.
+uint32_t entity_spawn(EntityManager* em, EntityType type, Vector2 position,
+                      Vector2 velocity, uint32_t owner_id, float rotation);
+void entity_despawn(EntityManager* em, uint32_t id);
+
+// Sync point (once per tick): apply queued spawns/despawns, then drop every
+// inactive entity in one stable compaction sweep
+void entity_apply_commands(EntityManager* em);
+
+Entity* entity_get_by_id(EntityManager* em, uint32_t id);  // NULL if the ID is stale or pending
 void entity_update_all(EntityManager* em, float delta_time);
+void entity_clamp_all(EntityManager* em, float min_x, float min_y, float max_x, float max_y);
 void entity_print_all(EntityManager* em);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "flow_field.h"
+#include "collision.h"
+#include "memory.h"
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define TILE ((float)DUNGEON_TILE_SIZE)
+#define FLOW_GOAL 0xFE             // Marks the goal while the BFS runs
+
+// Direction codes: orthogonal first (preferred on ties), each opposite
+// pair adjacent so code ^ 1 reverses a step
+static const int step_x[8] = {1, -1, 0, 0, 1, -1, -1, 1};
+static const int step_y[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+// Padded tile under a world position, or -1 off the grid
+static int tile_at(const FlowFieldSet* set, float x, float y) {
+    int tx = (int)floorf((x - set->origin_x) / TILE);
+    int ty = (int)floorf((y - set->origin_y) / TILE);
+    if (tx < 0 || ty < 0 || tx >= set->width || ty >= set->height) return -1;
+    return ty * set->width + tx;
+}
+
+void flow_field_init(FlowFieldSet* set, const Dungeon* dungeon) {
+    set->width = dungeon->width + 2;
+    set->height = dungeon->height + 2;
+    set->origin_x = dungeon->origin_x - TILE;
+    set->origin_y = dungeon->origin_y - TILE;
+
+    size_t tiles = (size_t)set->width * (size_t)set->height;
+    set->walkable = mem_alloc(tiles);
+    set->queue = mem_alloc(tiles * sizeof(uint32_t));
+    if (set->walkable == NULL || set->queue == NULL) {
+        fprintf(stderr, "Failed to allocate flow fields!\n");
+        exit(1);
+    }
+    for (int y = 0; y < set->height; y++) {
+        for (int x = 0; x < set->width; x++) {
+            set->walkable[y * set->width + x] = dungeon_tile_walkable(dungeon, x - 1, y - 1);
+        }
+    }
+
+    set->fields = NULL;
+    set->field_count = 0;
+    set->field_capacity = 0;
+    set->slot_field = NULL;
+    set->slot_capacity = 0;
+    set->rebuilds = 0;
+}
+
+void flow_field_free(FlowFieldSet* set) {
+    for (size_t i = 0; i < set->field_count; i++) {
+        mem_free(set->fields[i].next);
+    }
+    mem_free(set->fields);
+    mem_free(set->slot_field);
+    mem_free(set->walkable);
+    mem_free(set->queue);
+    set->fields = NULL;
+    set->slot_field = NULL;
+    set->walkable = NULL;
+    set->queue = NULL;
+    set->field_count = 0;
+    set->field_capacity = 0;
+    set->slot_capacity = 0;
+}
+
+void flow_field_build(FlowFieldSet* set, FlowField* field, int goal_x, int goal_y) {
+    int width = set->width;
+    size_t tiles = (size_t)width * (size_t)set->height;
+    const uint8_t* walkable = set->walkable;
+    uint8_t* next = field->next;
+    uint32_t* queue = set->queue;
+
+    memset(next, FLOW_NONE, tiles);
+    set->rebuilds++;
+    int goal = (goal_y + 1) * width + goal_x + 1;
+    field->goal = goal;
+    if (goal_x < 0 || goal_y < 0 || goal_x >= width - 2 || goal_y >= set->height - 2 ||
+        !walkable[goal]) {
+        return;
+    }
+
+    int offset[8];
+    for (int k = 0; k < 8; k++) {
+        offset[k] = step_y[k] * width + step_x[k];
+    }
+
+    // Breadth-first from the goal: each tile is reached first from a
+    // neighbour one step closer, which becomes its next step
+    next[goal] = FLOW_GOAL;
+    queue[0] = (uint32_t)goal;
+    size_t head = 0, tail = 1;
+    while (head < tail) {
+        int tile = (int)queue[head++];
+        for (int k = 0; k < 8; k++) {
+            int neighbour = tile + offset[k];
+            if (!walkable[neighbour] || next[neighbour] != FLOW_NONE) continue;
+            // Diagonals only where both orthogonal tiles are open (no wall corners)
+            if (k >= 4 && !(walkable[tile + step_x[k]] && walkable[tile + step_y[k] * width])) continue;
+
+            next[neighbour] = (uint8_t)(k ^ 1);
+            queue[tail++] = (uint32_t)neighbour;
+        }
+    }
+    next[goal] = FLOW_NONE;
+}
+
+// Free field for a new player (reused, or appended); FLOW_NO_FIELD if out of memory
+static uint32_t acquire_field(FlowFieldSet* set) {
+    for (size_t i = 0; i < set->field_count; i++) {
+        if (set->fields[i].player_id == 0) return (uint32_t)i;
+    }
+
+    if (set->field_count == set->field_capacity) {
+        size_t new_capacity = set->field_capacity > 0 ? set->field_capacity * 2 : 8;
+        FlowField* grown = mem_realloc(set->fields, new_capacity * sizeof(FlowField));
+        if (grown == NULL) {
+            LOG_ERROR("Failed to grow flow fields to %zu\n", new_capacity);
+            return FLOW_NO_FIELD;
+        }
+        set->fields = grown;
+        set->field_capacity = new_capacity;
+    }
+
+    FlowField* field = &set->fields[set->field_count];
+    field->next = mem_alloc((size_t)set->width * (size_t)set->height);
+    if (field->next == NULL) {
+        LOG_ERROR("Failed to allocate a flow field\n");
+        return FLOW_NO_FIELD;
+    }
+    field->player_id = 0;
+    return (uint32_t)set->field_count++;
+}
+
+const FlowField* flow_field_for_player(FlowFieldSet* set, const EntityManager* em, size_t player) {
+    int goal = tile_at(set, em->pos_x[player] + PLAYER_SIZE * 0.5f,
+                       em->pos_y[player] + PLAYER_SIZE * 0.5f);
+    if (goal < 0 || !set->walkable[goal]) return NULL;
+
+    uint32_t id = em->entities[player].id;
+    size_t slot = id & HANDLE_SLOT_MASK;
+    if (slot >= set->slot_capacity) {
+        size_t new_capacity = set->slot_capacity > 0 ? set->slot_capacity : 64;
+        while (new_capacity <= slot) new_capacity *= 2;
+        uint32_t* grown = mem_realloc(set->slot_field, new_capacity * sizeof(uint32_t));
+        if (grown == NULL) {
+            LOG_ERROR("Failed to grow flow field slots to %zu\n", new_capacity);
+            return NULL;
+        }
+        for (size_t i = set->slot_capacity; i < new_capacity; i++) {
+            grown[i] = FLOW_NO_FIELD;
+        }
+        set->slot_field = grown;
+        set->slot_capacity = new_capacity;
+    }
+
+    uint32_t index = set->slot_field[slot];
+    if (index == FLOW_NO_FIELD || set->fields[index].player_id != id) {
+        index = acquire_field(set);
+        if (index == FLOW_NO_FIELD) return NULL;
+        set->fields[index].player_id = id;
+        set->fields[index].goal = -1;
+        set->slot_field[slot] = index;
+    }
+
+    FlowField* field = &set->fields[index];
+    if (field->goal != goal) {
+        flow_field_build(set, field, goal % set->width - 1, goal / set->width - 1);
+    }
+    return field;
+}
+
+bool flow_field_direction(const FlowFieldSet* set, const FlowField* field,
+                          float x, float y, Vector2* direction) {
+    int tile = tile_at(set, x, y);
+    if (tile < 0) return false;
+    uint8_t code = field->next[tile];
+    if (code == FLOW_NONE) return false;
+
+    // Aim at the next tile's centre, which also pulls the enemy off wall edges
+    int tx = tile % set->width + step_x[code];
+    int ty = tile / set->width + step_y[code];
+    float dx = set->origin_x + ((float)tx + 0.5f) * TILE - x;
+    float dy = set->origin_y + ((float)ty + 0.5f) * TILE - y;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length <= 0.0f) return false;
+
+    direction->x = dx / length;
+    direction->y = dy / length;
+    return true;
+}
+
+void flow_field_prune(FlowFieldSet* set, const EntityManager* em) {
+    for (size_t i = 0; i < set->field_count; i++) {
+        uint32_t dense;
+        FlowField* field = &set->fields[i];
+        if (field->player_id != 0 && !handle_lookup(&em->handles, field->player_id, &dense)) {
+            field->player_id = 0;
+        }
+    }
+}
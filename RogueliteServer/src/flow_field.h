@@ -0,0 +1,67 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include "entity.h"
+#include "dungeon.h"
+#include "vector2.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Per-player flow fields for enemy chase steering. A field stores, for
+// every tile, which neighbour is one step closer to the player's tile
+// (BFS over floor tiles, 8-way without cutting wall corners). It is
+// rebuilt only when its player moves to another tile and shared by every
+// enemy chasing that player, so steering is one byte lookup per enemy.
+// A rebuild is a full BFS rather than an incremental repair: about 24 ns
+// per floor tile (~15 us on the 50x37 map, see benchmarks/bench_flow),
+// too little to justify LPA*-style bookkeeping at these sizes.
+//
+// Tiles are stored with a one-tile wall border so neighbour steps never
+// need bounds checks.
+#define FLOW_NONE 0xFF             // Goal tile, wall or unreachable: no step
+#define FLOW_NO_FIELD UINT32_MAX
+
+typedef struct {
+    uint32_t player_id;            // Entity ID the field leads to (0 = free slot)
+    int goal;                      // Padded tile the field was built for (-1 = never built)
+    uint8_t* next;                 // Padded tiles: direction code (0-7) of the next step, or FLOW_NONE
+} FlowField;
+
+typedef struct {
+    int width, height;             // Padded grid: the map plus a one-tile wall border
+    float origin_x, origin_y;      // World position of padded tile (0, 0)'s top-left corner
+    uint8_t* walkable;             // Padded tiles, 1 = floor
+    uint32_t* queue;               // BFS frontier (one tile per floor tile at most)
+
+    FlowField* fields;
+    size_t field_count;
+    size_t field_capacity;
+
+    uint32_t* slot_field;          // Player handle slot -> field index (or FLOW_NO_FIELD)
+    size_t slot_capacity;
+
+    uint64_t rebuilds;             // Lifetime counter
+} FlowFieldSet;
+
+void flow_field_init(FlowFieldSet* set, const Dungeon* dungeon);
+void flow_field_free(FlowFieldSet* set);
+
+// BFS from map tile (goal_x, goal_y) over the whole map
+void flow_field_build(FlowFieldSet* set, FlowField* field, int goal_x, int goal_y);
+
+// Field leading to the player at entity index 'player', rebuilt first if
+// the player's centre moved to another tile since the last build. NULL if
+// the player stands off the floor. Fields are created on first use.
+const FlowField* flow_field_for_player(FlowFieldSet* set, const EntityManager* em, size_t player);
+
+// Unit direction from world position (x, y) toward the centre of the next
+// tile on the way to the field's goal. False in the goal tile itself and
+// where no path exists; callers then steer straight at the player.
+bool flow_field_direction(const FlowFieldSet* set, const FlowField* field,
+                          float x, float y, Vector2* direction);
+
+// Free the fields of players that no longer exist (once per tick)
+void flow_field_prune(FlowFieldSet* set, const EntityManager* em);
+
+#endif
@@ -1,23 +1,18 @@
 #include "game_loop.h"
 #include "network.h"
 #include "collision.h"
+#include "tile_collision.h"
 #include "ai.h"
+#include "memory.h"
+#include "timing.h"
+#include "log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <math.h>
 
-#ifdef _WIN32
-#include <windows.h>
-#define sleep_ms(ms) Sleep(ms)
-#else
-#include <unistd.h>
-#define sleep_ms(ms) usleep((ms) * 1000)
-#endif
-
-#define TICK_RATE 60.0f
-#define TICK_TIME (1.0f / TICK_RATE)
-#define CLIENT_TIMEOUT 5.0f  // Disconnect after 5 seconds of no packets
+#define CLIENT_TIMEOUT 5.0  // Disconnect after 5 real seconds of no packets
+#define MAX_CATCHUP_STEPS 5 // Ticks run back-to-back before giving up and dropping time
 
 // Count alive enemies
 int wave_count_enemies(GameState* game) {
@@ -40,26 +35,14 @@ void wave_start(GameState* game) {
     // Calculate number of enemies for this wave
     int enemy_count = 3 + (game->current_wave - 1) * 2;  // 3, 5, 7, 9...
     
-    printf("\n=== WAVE %d STARTING - Spawning %d enemies ===\n", 
-           game->current_wave, enemy_count);
+    LOG_INFO("\n=== WAVE %d STARTING - Spawning %d enemies ===\n", 
+             game->current_wave, enemy_count);
     
-    // Spawn enemies in a circle, far from center
+    // Spawn enemies on open floor tiles
     for (int i = 0; i < enemy_count; i++) {
-        float angle = (i / (float)enemy_count) * 6.28318f;  // 2*PI
-        
-        // Spawn 250-350 pixels from center
-        float distance = 250.0f + (rand() % 100);
-        float x = 400.0f + cosf(angle) * distance;
-        float y = 300.0f + sinf(angle) * distance;
-        
-        // Clamp to map boundaries
-        if (x < MAP_MIN_X + 50) x = MAP_MIN_X + 50;
-        if (x > MAP_MAX_X - 50) x = MAP_MAX_X - 50;
-        if (y < MAP_MIN_Y + 50) y = MAP_MIN_Y + 50;
-        if (y > MAP_MAX_Y - 50) y = MAP_MAX_Y - 50;
-        
-        Vector2 enemy_pos = vector2_create(x, y);
-        entity_create(&game->entity_manager, ENTITY_TYPE_ENEMY, enemy_pos);
+        Vector2 enemy_pos = dungeon_random_spawn(&game->dungeon, &game->rng);
+        entity_spawn(&game->entity_manager, ENTITY_TYPE_ENEMY, enemy_pos,
+                     vector2_create(0.0f, 0.0f), 0, 0.0f);
     }
     
     game->enemies_alive = enemy_count;
@@ -74,8 +57,8 @@ void wave_update(GameState* game, float delta_time) {
         if (current_enemies == 0) {
             game->wave_active = false;
             game->wave_countdown = 5.0f;  // 5 second countdown
-            printf("\n=== WAVE %d COMPLETE! Next wave in 5 seconds... ===\n", 
-                   game->current_wave);
+            LOG_INFO("\n=== WAVE %d COMPLETE! Next wave in 5 seconds... ===\n", 
+                     game->current_wave);
         }
     } else {
         // Countdown to next wave
@@ -89,18 +72,37 @@ void wave_update(GameState* game, float delta_time) {
     game->enemies_alive = current_enemies;
 }
 
-void game_init(GameState* game, SOCKET sock) {
-    printf("=== INITIALIZING NETWORKED GAME ===\n");
+void game_init(GameState* game, SOCKET sock, const ServerConfig* config) {
+    LOG_INFO("=== INITIALIZING NETWORKED GAME ===\n");
     
-    // Seed random
-    srand((unsigned int)time(NULL));
+    // Everything random in the simulation derives from this seed
+    game->seed = config->seed != 0 ? config->seed : (uint64_t)time(NULL);
+    rng_seed(&game->rng, game->seed, 0);
+    dungeon_generate(&game->dungeon, rng_next(&game->rng), DUNGEON_WIDTH, DUNGEON_HEIGHT,
+                     MAP_MIN_X, MAP_MIN_Y);
     
+    game->config = *config;
     entity_manager_init(&game->entity_manager, 100);
+    projectile_pool_init(&game->projectiles, config->projectile_capacity);
+    spatial_hash_init(&game->broadphase, 256);
+    ai_system_init(&game->ai, config->ai_threads, &game->dungeon,
+                   MAP_MIN_X, MAP_MIN_Y, MAP_MAX_X, MAP_MAX_Y);
     game->running = true;
     game->total_time = 0.0f;
     game->tick_count = 0;
     game->socket = sock;
     game->client_count = 0;
+    udp_batch_init(&game->recv_batch, RECV_BATCH_SIZE, MAX_PACKET_SIZE);
+    udp_batch_init(&game->send_batch, SEND_BATCH_SIZE, 0);
+    game->inputs.head = 0;
+    game->inputs.count = 0;
+    game->inputs.dropped = 0;
+    game->socket_wakeups = 0;
+    game->stats_request_count = 0;
+    game->tick_allocs = 0;
+    game->catchup_steps = 0;
+    game->dropped_ticks = 0;
+    profiler_init(&game->profiler, NS_PER_SECOND / (uint64_t)config->tick_rate);
     
     // Initialize wave system
     game->current_wave = 0;
@@ -108,105 +110,240 @@ void game_init(GameState* game, SOCKET sock) {
     game->wave_countdown = 3.0f;  // Start first wave after 3 seconds
     game->wave_active = false;
     
-    // Initialize clients
-    for (int i = 0; i < MAX_CLIENTS; i++) {
+    // Initialize clients (all slots allocated up front)
+    int max_clients = config->max_clients;
+    game->clients = mem_alloc((size_t)max_clients * sizeof(NetworkClient));
+    game->free_client_slots = mem_alloc((size_t)max_clients * sizeof(int));
+    game->player_order = mem_alloc((size_t)max_clients * sizeof(int));
+    game->send_buffers = mem_alloc((size_t)SEND_BATCH_SIZE * MAX_PACKET_SIZE);
+    game->world_capacity = 64;
+    game->world_count = 0;
+    game->world_state = mem_alloc(game->world_capacity * sizeof(EntityState));
+    game->candidate_capacity = 128;
+    game->candidates = mem_alloc(game->candidate_capacity * sizeof(StateCandidate));
+    game->candidate_order = mem_alloc(game->candidate_capacity * sizeof(uint32_t));
+    game->state_bytes_sent = 0;
+    game->relevant_entities = 0;
+    interest_grid_init(&game->interest, MAP_MIN_X, MAP_MIN_Y, MAP_MAX_X, MAP_MAX_Y);
+    if (game->clients == NULL || game->free_client_slots == NULL || game->player_order == NULL ||
+        game->send_buffers == NULL || game->world_state == NULL ||
+        game->candidates == NULL || game->candidate_order == NULL) {
+        fprintf(stderr, "Failed to allocate client slots!\n");
+        exit(1);
+    }
+    client_table_init(&game->client_lookup, (size_t)max_clients);
+    
+    for (int i = 0; i < max_clients; i++) {
         game->clients[i].connected = false;
         game->clients[i].player_id = 0;
-        game->clients[i].last_packet_time = 0.0f;
+        game->clients[i].last_packet_time = 0.0;
         game->clients[i].kills = 0;
+        game->clients[i].name_tick = 0;
+        game->clients[i].view_x = 0.0f;
+        game->clients[i].view_y = 0.0f;
+        game->clients[i].state_bytes = 0;
+        game->clients[i].deferred_records = 0;
+        priority_list_init(&game->clients[i].priorities);
+        snapshot_ring_init(&game->clients[i].snapshots);
+        
+        // Pushed in reverse so slot 0 is handed out first
+        game->free_client_slots[i] = max_clients - 1 - i;
     }
+    game->free_client_count = max_clients;
     
-    printf("=== GAME INITIALIZED ===\n");
-    printf("First wave starts in 3 seconds...\n");
-    printf("Waiting for clients to connect...\n\n");
+    LOG_INFO("=== GAME INITIALIZED (%d Hz, up to %d clients, view radius %.0f, state budget %d bytes/tick) ===\n",
+             config->tick_rate, config->max_clients, config->view_radius, config->state_budget);
+    LOG_INFO("Tick profile every %d s (kill -USR1 for one now)\n", config->profile_interval);
+    LOG_INFO("Simulation seed %llu (replay with --seed), enemy AI on %d thread(s)\n",
+             (unsigned long long)game->seed, game->ai.workers.thread_count);
+    LOG_INFO("Dungeon %dx%d tiles, seed %u, %d floor tiles\n", game->dungeon.width,
+             game->dungeon.height, game->dungeon.seed, dungeon_floor_count(&game->dungeon));
+    LOG_INFO("First wave starts in 3 seconds...\n");
+    LOG_INFO("Waiting for clients to connect...\n\n");
 }
 
-void game_run_networked(GameState* game) {
-    printf("=== STARTING NETWORKED GAME LOOP ===\n\n");
+void game_simulate(GameState* game, float tick_time) {
+    // 1. Apply inputs received since the last tick
+    network_apply_inputs(game, tick_time);
+    profiler_end_phase(&game->profiler, PHASE_INPUT);
     
-    while (game->running) {
-        game->tick_count++;
-        game->total_time += TICK_TIME;
-        
-        // 1. Receive inputs from clients
-        network_receive_packets(game, TICK_TIME);
-        
-        // 2. Check for client timeouts
-        for (int i = 0; i < MAX_CLIENTS; i++) {
-            if (game->clients[i].connected) {
-                float time_since_packet = game->total_time - game->clients[i].last_packet_time;
-                if (time_since_packet > CLIENT_TIMEOUT) {
-                    printf("Client %d timed out\n", i);
-                    Entity* player = entity_get_by_id(&game->entity_manager, 
-                                                      game->clients[i].player_id);
-                    if (player) {
-                        player->active = false;
-                    }
-                    game->clients[i].connected = false;
-                    game->client_count--;
-                }
+    // 2. Update wave system
+    wave_update(game, tick_time);
+    profiler_end_phase(&game->profiler, PHASE_WAVE);
+    
+    // 3. Run game logic
+    ai_update_all(&game->ai, &game->entity_manager, &game->projectiles, tick_time,
+                  game->seed, (uint32_t)game->tick_count);
+    profiler_end_phase(&game->profiler, PHASE_AI);
+    tile_collision_move_entities(&game->entity_manager, &game->dungeon, tick_time);
+    tile_collision_projectiles(&game->projectiles, &game->dungeon, tick_time);
+    projectile_pool_update(&game->projectiles, tick_time,
+                           MAP_MIN_X, MAP_MIN_Y, MAP_MAX_X, MAP_MAX_Y);
+    profiler_end_phase(&game->profiler, PHASE_INTEGRATE);
+    
+    // 4. Apply map boundaries to all entities
+    entity_clamp_all(&game->entity_manager, MAP_MIN_X, MAP_MIN_Y, MAP_MAX_X, MAP_MAX_Y);
+    profiler_end_phase(&game->profiler, PHASE_CLAMP);
+    
+    // 5. Collision detection
+    collision_resolve_all(game);
+    profiler_end_phase(&game->profiler, PHASE_COLLISION);
+    
+    // 6. Sync point: apply queued spawns/despawns and compact dead entities
+    entity_apply_commands(&game->entity_manager);
+    projectile_pool_compact(&game->projectiles);
+    profiler_end_phase(&game->profiler, PHASE_SYNC);
+}
+
+// Run one networked tick of length tick_time
+static void game_tick(GameState* game, float tick_time) {
+    AllocStats allocs_before = mem_get_stats();
+    profiler_begin_tick(&game->profiler);
+    game->tick_count++;
+    game->total_time += tick_time;
+    
+    // 1. Check for client timeouts (real time, so a stalled loop doesn't hide them)
+    double now = timing_now_seconds();
+    for (int i = 0; i < game->config.max_clients; i++) {
+        if (game->clients[i].connected) {
+            double time_since_packet = now - game->clients[i].last_packet_time;
+            if (time_since_packet > CLIENT_TIMEOUT) {
+                LOG_INFO("Client %d timed out\n", i);
+                network_remove_client(game, &game->clients[i]);
             }
         }
+    }
+    profiler_end_phase(&game->profiler, PHASE_TIMEOUTS);
+    
+    // 2. Inputs, waves, AI, movement, collisions, sync
+    game_simulate(game, tick_time);
+    
+    // 3. Broadcast state to clients
+    network_broadcast_state(game);
+    profiler_end_phase(&game->profiler, PHASE_BROADCAST);
+    
+    game->tick_allocs += mem_get_stats().allocs - allocs_before.allocs;
+    
+    // 4. Print state once per second
+    if (game->tick_count % game->config.tick_rate == 0) {
+        LOG_INFO("=== TICK %d (%.1fs) - Clients: %d - Wave: %d - Enemies: %d ===\n",
+                 game->tick_count, game->total_time, game->client_count, 
+                 game->current_wave, game->enemies_alive);
         
-        // 3. Update wave system
-        wave_update(game, TICK_TIME);
-        
-        // 4. Run game logic
-        ai_update_all(&game->entity_manager, TICK_TIME);
-        entity_update_all(&game->entity_manager, TICK_TIME);
-        
-        // 5. Apply map boundaries to all entities
-        for (size_t i = 0; i < game->entity_manager.count; i++) {
-            Entity* e = &game->entity_manager.entities[i];
-            if (!e->active) continue;
-            
-            // Clamp position to map bounds
-            if (e->position.x < MAP_MIN_X) {
-                e->position.x = MAP_MIN_X;
-                e->velocity.x = 0;
-            }
-            if (e->position.x > MAP_MAX_X) {
-                e->position.x = MAP_MAX_X;
-                e->velocity.x = 0;
-            }
-            if (e->position.y < MAP_MIN_Y) {
-                e->position.y = MAP_MIN_Y;
-                e->velocity.y = 0;
-            }
-            if (e->position.y > MAP_MAX_Y) {
-                e->position.y = MAP_MAX_Y;
-                e->velocity.y = 0;
+        // Print kill counts and each client's share of the STATE bandwidth
+        for (int i = 0; i < game->config.max_clients; i++) {
+            NetworkClient* client = &game->clients[i];
+            if (client->connected) {
+                LOG_INFO("  Client %d: %d kills - state %llu bytes/s - %llu updates deferred\n",
+                         i, client->kills,
+                         (unsigned long long)client->state_bytes,
+                         (unsigned long long)client->deferred_records);
             }
+            client->state_bytes = 0;
+            client->deferred_records = 0;
         }
         
-        // 6. Collision detection
-        collision_resolve_all(game);
-        
-        // 7. Broadcast state to clients
-        network_broadcast_state(game);
+        // Steady state should show 0 heap allocations per tick
+        LOG_INFO("  Projectiles: %zu/%zu (dropped %llu) - Heap allocs last second: %llu - Log records dropped: %llu\n",
+                 game->projectiles.count, game->projectiles.capacity,
+                 (unsigned long long)game->projectiles.dropped,
+                 (unsigned long long)game->tick_allocs,
+                 (unsigned long long)log_dropped());
+        LOG_INFO("  Scheduler: catch-up %llu - dropped %llu\n",
+                 (unsigned long long)game->catchup_steps,
+                 (unsigned long long)game->dropped_ticks);
+        LOG_INFO("  Network: %llu socket wakeups - %llu inputs dropped - syscalls recv %llu / send %llu\n",
+                 (unsigned long long)game->socket_wakeups,
+                 (unsigned long long)game->inputs.dropped,
+                 (unsigned long long)game->recv_batch.syscalls,
+                 (unsigned long long)game->send_batch.syscalls);
+        if (game->client_count > 0) {
+            uint64_t client_ticks = (uint64_t)game->client_count * (uint64_t)game->config.tick_rate;
+            LOG_INFO("  State: %llu bytes/s (%llu per client) - %.1f of %zu entities relevant per client\n",
+                     (unsigned long long)game->state_bytes_sent,
+                     (unsigned long long)(game->state_bytes_sent / (uint64_t)game->client_count),
+                     (double)game->relevant_entities / (double)client_ticks,
+                     game->world_count);
+        }
+        game->state_bytes_sent = 0;
+        game->relevant_entities = 0;
+        game->tick_allocs = 0;
+        game->catchup_steps = 0;
+        game->dropped_ticks = 0;
+        game->socket_wakeups = 0;
+        game->recv_batch.syscalls = 0;
+        game->send_batch.syscalls = 0;
+    }
+    profiler_end_phase(&game->profiler, PHASE_STATUS);
+    profiler_end_tick(&game->profiler);
+    
+    // 5. Phase timings every profile_interval seconds, or on request (SIGUSR1)
+    int report_ticks = game->config.profile_interval * game->config.tick_rate;
+    if (game->tick_count % report_ticks == 0 || profiler_report_requested()) {
+        profiler_report(&game->profiler);
+    }
+}
+
+// Fixed-timestep loop on the monotonic clock.
+// next_tick is the absolute deadline of the next tick; everything from it to
+// 'now' is the accumulator. We run one tick per elapsed tick length (at most
+// MAX_CATCHUP_STEPS back-to-back), then wait on the socket until the next
+// deadline, so inputs are decoded as they arrive rather than at tick start.
+void game_run_networked(GameState* game) {
+    LOG_INFO("=== STARTING NETWORKED GAME LOOP ===\n\n");
+    
+    uint64_t tick_ns = NS_PER_SECOND / (uint64_t)game->config.tick_rate;
+    float tick_time = 1.0f / (float)game->config.tick_rate;
+    uint64_t next_tick = timing_now_ns();
+    
+    while (game->running) {
+        uint64_t now = timing_now_ns();
+        int steps = 0;
         
-        // 8. Print state every 60 ticks (1 second)
-        if (game->tick_count % 60 == 0) {
-            printf("=== TICK %d (%.1fs) - Clients: %d - Wave: %d - Enemies: %d ===\n",
-                   game->tick_count, game->total_time, game->client_count, 
-                   game->current_wave, game->enemies_alive);
+        // Consume accumulated time in fixed steps
+        while (now >= next_tick && steps < MAX_CATCHUP_STEPS && game->running) {
+            game_tick(game, tick_time);
+            if (steps > 0) game->catchup_steps++;
             
-            // Print kill counts
-            for (int i = 0; i < MAX_CLIENTS; i++) {
-                if (game->clients[i].connected) {
-                    printf("  Client %d: %d kills\n", i, game->clients[i].kills);
-                }
-            }
+            next_tick += tick_ns;
+            now = timing_now_ns();
+            steps++;
         }
         
-        // 9. Sleep to maintain 60 Hz
-        sleep_ms(16);
+        // Still behind after the catch-up budget: drop the backlog rather
+        // than spiral (simulated time falls behind real time by that much)
+        if (now >= next_tick) {
+            uint64_t behind = (now - next_tick) / tick_ns + 1;
+            game->dropped_ticks += behind;
+            next_tick += behind * tick_ns;
+        }
+        
+        network_wait(game, next_tick);
     }
     
-    printf("\n=== GAME LOOP ENDED ===\n");
+    LOG_INFO("\n=== GAME LOOP ENDED ===\n");
 }
 
 void game_cleanup(GameState* game) {
     entity_manager_free(&game->entity_manager);
-    printf("=== GAME CLEANUP COMPLETE ===\n");
+    projectile_pool_free(&game->projectiles);
+    spatial_hash_free(&game->broadphase);
+    ai_system_free(&game->ai);
+    dungeon_free(&game->dungeon);
+    udp_batch_free(&game->recv_batch);
+    udp_batch_free(&game->send_batch);
+    client_table_free(&game->client_lookup);
+    for (int i = 0; i < game->config.max_clients; i++) {
+        snapshot_ring_free(&game->clients[i].snapshots);
+        priority_list_free(&game->clients[i].priorities);
+    }
+    mem_free(game->clients);
+    mem_free(game->free_client_slots);
+    mem_free(game->player_order);
+    mem_free(game->send_buffers);
+    mem_free(game->world_state);
+    mem_free(game->candidates);
+    mem_free(game->candidate_order);
+    interest_grid_free(&game->interest);
+    LOG_INFO("=== GAME CLEANUP COMPLETE ===\n");
 }
@@ -2,60 +2,139 @@
 #define GAME_LOOP_H
 
 #include "entity.h"
+#include "spatial_hash.h"
+#include "projectile_pool.h"
+#include "config.h"
+#include "protocol.h"
+#include "udp_batch.h"   // Also provides SOCKET / sockaddr_in on every platform
+#include "client_table.h"
+#include "snapshot.h"
+#include "interest.h"
+#include "priority.h"
+#include "profiler.h"
+#include "rng.h"
+#include "ai.h"
+#include "dungeon.h"
 
-#ifdef _WIN32
-    #include <winsock2.h>
-    typedef int socklen_t;
-#else
-    #include <sys/socket.h>
-    #include <netinet/in.h>
-    typedef int SOCKET;
-    #define INVALID_SOCKET -1
-#endif
+// Datagrams per recvmmsg call
+#define RECV_BATCH_SIZE 64
+
+// Datagrams per sendmmsg call (STATE fragments for all clients go out in batches of this)
+#define SEND_BATCH_SIZE 64
 
-// Maximum clients
-#define MAX_CLIENTS 4
+// Inputs decoded on arrival, waiting for the next tick
+#define INPUT_QUEUE_CAPACITY 1024
 
-// Map boundaries (match client grid)
-#define MAP_MIN_X -400.0f
-#define MAP_MIN_Y -300.0f
-#define MAP_MAX_X 1200.0f
-#define MAP_MAX_Y 900.0f
+typedef struct {
+    uint32_t player_id;        // Sender's player entity
+    InputMessage input;
+} QueuedInput;
+
+// Fixed ring buffer (filled between ticks, emptied by the tick)
+typedef struct {
+    QueuedInput items[INPUT_QUEUE_CAPACITY];
+    size_t head;
+    size_t count;
+    uint64_t dropped;          // Inputs lost because the queue was full
+} InputQueue;
 
 // Client info
 typedef struct {
     struct sockaddr_in addr;   // Client's IP:Port
     uint32_t player_id;        // Their entity ID
-    float last_packet_time;    // Time of last packet (for timeout)
+    double last_packet_time;   // timing_now_seconds() of last packet (for timeout)
     bool connected;
     int kills;                 // Kill counter
     char player_name[32];      // NEW: Store player name
+    uint32_t name_tick;        // First tick broadcast after the name was set
+    SnapshotRing snapshots;    // Sent frames + last acked one (delta baselines)
+    float view_x, view_y;      // Center of the client's area of interest (last player position)
+    PriorityList priorities;   // Per-entity send priority accumulators
+    uint64_t state_bytes;      // STATE bytes sent since the last status print
+    uint64_t deferred_records; // Entity updates held back by the budget since the last status print
+    
+    // Totals for the metrics endpoint (since connecting)
+    uint32_t rtt_us;           // Smoothed STATE-to-ACK round trip (0 = no ACK yet)
+    uint64_t bytes_sent;
+    uint64_t bytes_received;
+    uint32_t packets_sent;
+    uint32_t packets_received;
 } NetworkClient;
 
+// Metrics requests wait for idle time between ticks; extras are dropped
+#define STATS_REQUEST_QUEUE 8
+
+typedef struct {
+    struct sockaddr_in addr;
+    uint16_t first_client;
+} StatsRequest;
+
 // Game state (updated)
 typedef struct {
-    EntityManager entity_manager;
+    ServerConfig config;
+    EntityManager entity_manager;   // Players and enemies
+    ProjectilePool projectiles;     // All projectiles (fixed capacity)
+    SpatialHash broadphase;    // Collision broadphase, rebuilt every tick
+    AISystem ai;               // Enemy AI decision buffers and worker threads
     bool running;
-    float total_time;
+    float total_time;          // Simulated time (tick_count * tick length)
     int tick_count;
+    uint64_t seed;             // Simulation seed (--seed, else the clock); logged so a run can be replayed
+    Rng rng;                   // Game-wide stream (dungeon seed, spawns); entities derive their own
+    Dungeon dungeon;           // Walkable tiles (generated from a seed drawn from rng)
+    
+    // Scheduler accounting (reset with each status print)
+    uint64_t catchup_steps;    // Extra ticks run back-to-back to catch up
+    uint64_t dropped_ticks;    // Ticks skipped when too far behind
+    Profiler profiler;         // Per-phase tick timings (tick overruns too)
     
     // Network fields
     SOCKET socket;
-    NetworkClient clients[MAX_CLIENTS];
+    NetworkClient* clients;    // config.max_clients slots
     int client_count;
+    ClientTable client_lookup; // (IP, port) -> slot in clients
+    int* free_client_slots;    // Stack of unused slots
+    int free_client_count;
+    
+    // STATE broadcast scratch (allocated once)
+    EntityState* world_state;  // This tick's entities, sorted by id
+    size_t world_count;
+    size_t world_capacity;
+    InterestGrid interest;     // world_state bucketed by position, for per-client relevance
+    int* player_order;         // Connected client slots, sorted by player_id
+    StateCandidate* candidates; // One client's possible entity records this tick (ID order)
+    uint32_t* candidate_order; // Candidate indices by descending priority
+    size_t candidate_capacity;
+    uint8_t* send_buffers;     // One MAX_PACKET_SIZE buffer per send batch slot
+    uint64_t state_bytes_sent; // Since the last status print
+    uint64_t relevant_entities; // Entities relevant to some client, summed per client per tick
+    UdpBatch recv_batch;       // Preallocated receive buffers
+    UdpBatch send_batch;       // STATE fragments, sent a batch per syscall
+    InputQueue inputs;
+    uint64_t socket_wakeups;   // Times the idle wait woke up for packets
+    StatsRequest stats_requests[STATS_REQUEST_QUEUE];
+    int stats_request_count;
     
     // NEW: Wave system
     int current_wave;
     int enemies_alive;
     float wave_countdown;
     bool wave_active;
+    
+    // Heap allocations made by ticks since the last status print
+    uint64_t tick_allocs;
 } GameState;
 
 // Functions
-void game_init(GameState* game, SOCKET sock);
+void game_init(GameState* game, SOCKET sock, const ServerConfig* config);
 void game_run_networked(GameState* game);
 void game_cleanup(GameState* game);
 
+// The simulation part of a tick: queued inputs, waves, AI, movement,
+// collisions and the end-of-tick sync point, each closed as a profiler
+// phase. The networked loop and --bench both run ticks through this.
+void game_simulate(GameState* game, float tick_time);
+
 // NEW: Wave functions
 void wave_start(GameState* game);
 void wave_update(GameState* game, float delta_time);
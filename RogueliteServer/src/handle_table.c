@@ -0,0 +1,131 @@
+#include "handle_table.h"
+#include "memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FREE_LIST_END UINT32_MAX
+
+static uint32_t make_handle(const HandleTable* table, uint32_t slot) {
+    return table->tag | ((uint32_t)table->generation[slot] << HANDLE_SLOT_BITS) | slot;
+}
+
+// True if the handle carries this table's tag and its slot's current generation
+static bool handle_is_current(const HandleTable* table, uint32_t handle) {
+    if ((handle & HANDLE_TAG_BIT) != table->tag) return false;
+
+    uint32_t slot = handle & HANDLE_SLOT_MASK;
+    if (slot >= table->slot_count) return false;
+
+    uint32_t gen = (handle >> HANDLE_SLOT_BITS) & HANDLE_GENERATION_MASK;
+    return gen == table->generation[slot];
+}
+
+// Grow slot arrays (never past HANDLE_MAX_SLOTS)
+static bool grow_slots(HandleTable* table) {
+    if (table->slot_capacity >= HANDLE_MAX_SLOTS) return false;
+
+    size_t new_capacity = table->slot_capacity * 2;
+    if (new_capacity > HANDLE_MAX_SLOTS) new_capacity = HANDLE_MAX_SLOTS;
+
+    uint32_t* dense = mem_realloc(table->dense, new_capacity * sizeof(uint32_t));
+    if (dense == NULL) return false;
+    table->dense = dense;
+
+    uint16_t* generation = mem_realloc(table->generation, new_capacity * sizeof(uint16_t));
+    if (generation == NULL) return false;
+    table->generation = generation;
+
+    table->slot_capacity = new_capacity;
+    return true;
+}
+
+// Initialize handle table
+void handle_table_init(HandleTable* table, size_t initial_slots, uint32_t tag) {
+    if (initial_slots < 1) initial_slots = 1;
+    if (initial_slots > HANDLE_MAX_SLOTS) initial_slots = HANDLE_MAX_SLOTS;
+
+    table->dense = mem_alloc(initial_slots * sizeof(uint32_t));
+    table->generation = mem_alloc(initial_slots * sizeof(uint16_t));
+
+    if (table->dense == NULL || table->generation == NULL) {
+        fprintf(stderr, "Failed to allocate handle table!\n");
+        exit(1);
+    }
+
+    table->slot_count = 0;
+    table->slot_capacity = initial_slots;
+    table->free_head = FREE_LIST_END;
+    table->free_tail = FREE_LIST_END;
+    table->tag = tag;
+}
+
+// Free handle table
+void handle_table_free(HandleTable* table) {
+    mem_free(table->dense);
+    mem_free(table->generation);
+    table->dense = NULL;
+    table->generation = NULL;
+    table->slot_count = 0;
+    table->slot_capacity = 0;
+    table->free_head = FREE_LIST_END;
+    table->free_tail = FREE_LIST_END;
+}
+
+// Allocate a handle (reuses the oldest freed slot first)
+uint32_t handle_alloc(HandleTable* table, uint32_t dense) {
+    uint32_t slot;
+
+    if (table->free_head != FREE_LIST_END) {
+        // Pop from the front of the free FIFO
+        slot = table->free_head;
+        table->free_head = table->dense[slot];
+        if (table->free_head == FREE_LIST_END) {
+            table->free_tail = FREE_LIST_END;
+        }
+    } else {
+        if (table->slot_count >= table->slot_capacity && !grow_slots(table)) {
+            return HANDLE_INVALID;
+        }
+        slot = (uint32_t)table->slot_count++;
+        table->generation[slot] = 1;  // Generation 0 is never used, so handles are never 0
+    }
+
+    table->dense[slot] = dense;
+    return make_handle(table, slot);
+}
+
+// Release a handle and bump its slot's generation
+void handle_release(HandleTable* table, uint32_t handle) {
+    if (!handle_is_current(table, handle)) return;  // Stale or foreign: nothing to do
+
+    uint32_t slot = handle & HANDLE_SLOT_MASK;
+
+    // Next generation, skipping 0
+    uint16_t gen = (uint16_t)((table->generation[slot] + 1) & HANDLE_GENERATION_MASK);
+    table->generation[slot] = gen ? gen : 1;
+
+    // Push onto the back of the free FIFO
+    table->dense[slot] = FREE_LIST_END;
+    if (table->free_tail != FREE_LIST_END) {
+        table->dense[table->free_tail] = slot;
+    } else {
+        table->free_head = slot;
+    }
+    table->free_tail = slot;
+}
+
+// Repoint a live handle
+void handle_set_dense(HandleTable* table, uint32_t handle, uint32_t dense) {
+    table->dense[handle & HANDLE_SLOT_MASK] = dense;
+}
+
+// Resolve handle to dense index, rejecting stale generations
+bool handle_lookup(const HandleTable* table, uint32_t handle, uint32_t* dense) {
+    if (!handle_is_current(table, handle)) return false;
+
+    uint32_t d = table->dense[handle & HANDLE_SLOT_MASK];
+    if (d == HANDLE_NO_DENSE) return false;
+
+    *dense = d;
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef HANDLE_TABLE_H
+#define HANDLE_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Generational handles: [tag:1][generation:15][slot:16]
+// The slot indexes a sparse array that maps to the owner's dense index;
+// the generation is bumped every time a slot is freed, so a handle kept
+// after its object was destroyed (or the slot reused) no longer resolves.
+#define HANDLE_SLOT_BITS 16
+#define HANDLE_SLOT_MASK 0xFFFFu
+#define HANDLE_MAX_SLOTS (1u << HANDLE_SLOT_BITS)
+#define HANDLE_GENERATION_MASK 0x7FFFu
+#define HANDLE_TAG_BIT 0x80000000u   // Free for owners to mark their handle space
+#define HANDLE_INVALID 0u
+
+#define HANDLE_NO_DENSE UINT32_MAX
+
+typedef struct {
+    uint32_t* dense;          // slot -> dense index (or next free slot while free)
+    uint16_t* generation;     // slot -> current generation (1..HANDLE_GENERATION_MASK)
+    size_t slot_count;        // Slots ever handed out
+    size_t slot_capacity;
+    uint32_t free_head;       // FIFO of freed slots (oldest reused first)
+    uint32_t free_tail;
+    uint32_t tag;             // OR'd into every handle (0 or HANDLE_TAG_BIT)
+} HandleTable;
+
+void handle_table_init(HandleTable* table, size_t initial_slots, uint32_t tag);
+void handle_table_free(HandleTable* table);
+
+// Allocate a handle pointing at 'dense' (returns HANDLE_INVALID when full)
+uint32_t handle_alloc(HandleTable* table, uint32_t dense);
+
+// Release a handle; it (and any copies of it) stop resolving immediately
+void handle_release(HandleTable* table, uint32_t handle);
+
+// Point a live handle at a new dense index (after swap-and-pop moves it)
+void handle_set_dense(HandleTable* table, uint32_t handle, uint32_t dense);
+
+// Resolve a handle to its dense index. Returns false for stale, freed,
+// foreign-tag or pending (HANDLE_NO_DENSE) handles.
+bool handle_lookup(const HandleTable* table, uint32_t handle, uint32_t* dense);
+
+#endif
@@ -0,0 +1,145 @@
+#include "interest.h"
+#include "memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Cell coordinate along one axis, clamped to the grid
+static int cell_coord(float position, float min, int cells) {
+    int c = (int)floorf((position - min) / INTEREST_CELL_SIZE);
+    if (c < 0) return 0;
+    if (c >= cells) return cells - 1;
+    return c;
+}
+
+static size_t cell_of(const InterestGrid* grid, const EntityState* e) {
+    int cx = cell_coord(e->x, grid->min_x, grid->cells_x);
+    int cy = cell_coord(e->y, grid->min_y, grid->cells_y);
+    return (size_t)cy * (size_t)grid->cells_x + (size_t)cx;
+}
+
+// Grow a uint32 array so it can hold 'needed' values (never shrinks)
+static uint32_t* ensure_capacity(uint32_t* array, size_t* capacity, size_t needed) {
+    if (needed <= *capacity) return array;
+
+    size_t new_capacity = *capacity;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+
+    uint32_t* grown = mem_realloc(array, new_capacity * sizeof(uint32_t));
+    if (grown == NULL) {
+        fprintf(stderr, "Failed to grow interest grid!\n");
+        exit(1);
+    }
+
+    *capacity = new_capacity;
+    return grown;
+}
+
+// Initialize interest grid
+void interest_grid_init(InterestGrid* grid, float min_x, float min_y, float max_x, float max_y) {
+    grid->min_x = min_x;
+    grid->min_y = min_y;
+    grid->cells_x = (int)ceilf((max_x - min_x) / INTEREST_CELL_SIZE);
+    grid->cells_y = (int)ceilf((max_y - min_y) / INTEREST_CELL_SIZE);
+    if (grid->cells_x < 1) grid->cells_x = 1;
+    if (grid->cells_y < 1) grid->cells_y = 1;
+
+    size_t cells = (size_t)grid->cells_x * (size_t)grid->cells_y;
+    grid->cell_start = mem_alloc((cells + 1) * sizeof(uint32_t));
+    grid->entry_capacity = 256;
+    grid->entries = mem_alloc(grid->entry_capacity * sizeof(uint32_t));
+    grid->result_capacity = 256;
+    grid->result_count = 0;
+    grid->results = mem_alloc(grid->result_capacity * sizeof(uint32_t));
+
+    if (grid->cell_start == NULL || grid->entries == NULL || grid->results == NULL) {
+        fprintf(stderr, "Failed to allocate interest grid!\n");
+        exit(1);
+    }
+    memset(grid->cell_start, 0, (cells + 1) * sizeof(uint32_t));
+}
+
+// Free interest grid
+void interest_grid_free(InterestGrid* grid) {
+    mem_free(grid->cell_start);
+    mem_free(grid->entries);
+    mem_free(grid->results);
+    grid->cell_start = NULL;
+    grid->entries = NULL;
+    grid->results = NULL;
+    grid->entry_capacity = 0;
+    grid->result_capacity = 0;
+    grid->result_count = 0;
+}
+
+// Rebuild grid from the world state (counting sort into cells)
+void interest_grid_build(InterestGrid* grid, const EntityState* world, size_t count) {
+    size_t cells = (size_t)grid->cells_x * (size_t)grid->cells_y;
+    uint32_t* start = grid->cell_start;
+    memset(start, 0, (cells + 1) * sizeof(uint32_t));
+
+    grid->entries = ensure_capacity(grid->entries, &grid->entry_capacity, count);
+
+    // Pass 1: count entries per cell
+    for (size_t i = 0; i < count; i++) {
+        start[cell_of(grid, &world[i]) + 1]++;
+    }
+
+    // Pass 2: prefix sum turns counts into start offsets
+    for (size_t c = 0; c < cells; c++) {
+        start[c + 1] += start[c];
+    }
+
+    // Pass 3: scatter indices in ascending order (start[c] is the write cursor)
+    for (size_t i = 0; i < count; i++) {
+        grid->entries[start[cell_of(grid, &world[i])]++] = (uint32_t)i;
+    }
+
+    // Cursors now sit at each cell's end; shift back down to restore starts
+    memmove(&start[1], &start[0], cells * sizeof(uint32_t));
+    start[0] = 0;
+}
+
+static int compare_index(const void* a, const void* b) {
+    uint32_t ia = *(const uint32_t*)a;
+    uint32_t ib = *(const uint32_t*)b;
+    return (ia > ib) - (ia < ib);
+}
+
+// Collect entities within radius from the cells the circle overlaps
+const uint32_t* interest_grid_query(InterestGrid* grid, const EntityState* world,
+                                    float x, float y, float radius, size_t* count) {
+    int min_cx = cell_coord(x - radius, grid->min_x, grid->cells_x);
+    int max_cx = cell_coord(x + radius, grid->min_x, grid->cells_x);
+    int min_cy = cell_coord(y - radius, grid->min_y, grid->cells_y);
+    int max_cy = cell_coord(y + radius, grid->min_y, grid->cells_y);
+    float radius_sq = radius * radius;
+
+    grid->result_count = 0;
+    for (int cy = min_cy; cy <= max_cy; cy++) {
+        // Cells in a row are contiguous, so the row is one run of entries
+        size_t row = (size_t)cy * (size_t)grid->cells_x;
+        uint32_t first = grid->cell_start[row + (size_t)min_cx];
+        uint32_t last = grid->cell_start[row + (size_t)max_cx + 1];
+
+        grid->results = ensure_capacity(grid->results, &grid->result_capacity,
+                                        grid->result_count + (last - first));
+        for (uint32_t k = first; k < last; k++) {
+            uint32_t index = grid->entries[k];
+            float dx = world[index].x - x;
+            float dy = world[index].y - y;
+            if (dx * dx + dy * dy <= radius_sq) {
+                grid->results[grid->result_count++] = index;
+            }
+        }
+    }
+
+    // Rows come out interleaved; restore ascending index order for the merge
+    qsort(grid->results, grid->result_count, sizeof(uint32_t), compare_index);
+
+    *count = grid->result_count;
+    return grid->results;
+}
@@ -0,0 +1,38 @@
+#ifndef INTEREST_H
+#define INTEREST_H
+
+#include "protocol.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// Cell size for relevance queries (a view radius spans a handful of cells)
+#define INTEREST_CELL_SIZE 256.0f
+
+// Uniform grid over the map for per-client relevance queries. Built once a
+// tick from the broadcast world state (players, enemies and projectiles);
+// each cell holds a contiguous run of world_state indices (counting sort),
+// so neither build nor query allocates once warm.
+typedef struct {
+    float min_x, min_y;       // World position of cell (0, 0)
+    int cells_x, cells_y;
+    uint32_t* cell_start;     // cells_x * cells_y + 1 offsets into entries
+    uint32_t* entries;        // World state indices grouped by cell
+    size_t entry_capacity;
+    uint32_t* results;        // Last query's indices, ascending
+    size_t result_count;
+    size_t result_capacity;
+} InterestGrid;
+
+// Covers [min, max]; entities outside are counted in the nearest edge cell
+void interest_grid_init(InterestGrid* grid, float min_x, float min_y, float max_x, float max_y);
+void interest_grid_free(InterestGrid* grid);
+
+// Rebuild from this tick's world state
+void interest_grid_build(InterestGrid* grid, const EntityState* world, size_t count);
+
+// Indices of entities within radius of (x, y), ascending (so in entity_id
+// order when the world state is sorted by ID). Valid until the next query.
+const uint32_t* interest_grid_query(InterestGrid* grid, const EntityState* world,
+                                    float x, float y, float radius, size_t* count);
+
+#endif
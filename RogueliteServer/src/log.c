@@ -0,0 +1,367 @@
+#define _POSIX_C_SOURCE 200809L  // nanosleep under -std=c11
+#include "log.h"
+#include "memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#define LOG_RING_SIZE 8192          // Records (power of two)
+#define LOG_MAX_ARGS 8
+#define LOG_STRING_BYTES 64         // Shared by all %s arguments of a record
+#define LOG_LINE_SIZE 512
+#define LOG_IDLE_SLEEP_MS 2         // Writer thread poll interval when the ring is empty
+
+typedef union {
+    long long i;
+    unsigned long long u;
+    double d;
+    const void* p;
+    size_t string_offset;           // Into the record's strings
+} LogArg;
+
+typedef struct {
+    const char* format;
+    uint8_t level;
+    uint8_t arg_count;
+    LogArg args[LOG_MAX_ARGS];
+    char strings[LOG_STRING_BYTES];
+} LogRecord;
+
+typedef enum {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING,
+    LOG_ARG_POINTER
+} LogArgType;
+
+// Integer length modifiers we read back with va_arg
+typedef enum {
+    LOG_LENGTH_NONE,
+    LOG_LENGTH_LONG,
+    LOG_LENGTH_LONG_LONG,
+    LOG_LENGTH_SIZE
+} LogLength;
+
+#define LOG_CACHE_LINE 64
+
+// Producer and consumer indices on separate cache lines so the two
+// threads don't invalidate each other's line on every record
+typedef struct {
+    LogRecord* records;
+    _Alignas(LOG_CACHE_LINE) _Atomic size_t head;   // Next slot to write (producer)
+    size_t tail_cache;                              // Producer's last view of tail
+    _Atomic uint64_t dropped;
+    _Alignas(LOG_CACHE_LINE) _Atomic size_t tail;   // Next slot to read (consumer)
+    _Atomic bool running;
+#ifdef _WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+} Logger;
+
+static Logger g_log;
+static const char* level_prefix[] = {"", "", "WARNING: ", "ERROR: "};
+
+// Find the next conversion in a format string. Returns the '%' (NULL at
+// the end); *end is set past the conversion. "%%" is reported with
+// has_arg false.
+static const char* next_conversion(const char* p, const char** end, bool* has_arg,
+                                   LogArgType* type, LogLength* length) {
+    p = strchr(p, '%');
+    if (p == NULL) return NULL;
+
+    const char* c = p + 1;
+    if (*c == '%') {
+        *end = c + 1;
+        *has_arg = false;
+        return p;
+    }
+
+    while (*c && strchr("-+ #0", *c)) c++;                   // Flags
+    while (*c >= '0' && *c <= '9') c++;                      // Width
+    if (*c == '.') {                                         // Precision
+        c++;
+        while (*c >= '0' && *c <= '9') c++;
+    }
+
+    *length = LOG_LENGTH_NONE;
+    if (*c == 'h') {
+        c++;
+        if (*c == 'h') c++;
+    } else if (*c == 'l') {
+        c++;
+        *length = LOG_LENGTH_LONG;
+        if (*c == 'l') {
+            c++;
+            *length = LOG_LENGTH_LONG_LONG;
+        }
+    } else if (*c == 'z') {
+        c++;
+        *length = LOG_LENGTH_SIZE;
+    }
+
+    switch (*c) {
+        case 'd': case 'i': case 'c': *type = LOG_ARG_INT; break;
+        case 'u': case 'x': case 'X': case 'o': *type = LOG_ARG_UINT; break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            *type = LOG_ARG_DOUBLE; break;
+        case 's': *type = LOG_ARG_STRING; break;
+        case 'p': *type = LOG_ARG_POINTER; break;
+        default:
+            return NULL;  // Unsupported: stop here, rest of the format is printed verbatim
+    }
+
+    *end = c + 1;
+    *has_arg = true;
+    return p;
+}
+
+// Format a record into line (always NUL-terminated); returns the length
+static size_t format_record(const LogRecord* record, char* line, size_t size) {
+    size_t len = (size_t)snprintf(line, size, "%s", level_prefix[record->level]);
+    const char* p = record->format;
+    int arg = 0;
+
+    while (len < size - 1) {
+        const char* end;
+        bool has_arg;
+        LogArgType type;
+        LogLength length;
+        const char* conversion = next_conversion(p, &end, &has_arg, &type, &length);
+        if (conversion == NULL || (has_arg && arg >= record->arg_count)) {
+            len += (size_t)snprintf(line + len, size - len, "%s", p);
+            break;
+        }
+
+        // Literal text before the conversion
+        size_t literal = (size_t)(conversion - p);
+        if (literal > size - 1 - len) literal = size - 1 - len;
+        memcpy(line + len, p, literal);
+        len += literal;
+        p = end;
+
+        if (!has_arg) {
+            if (len < size - 1) line[len++] = '%';
+            continue;
+        }
+
+        char spec[32];
+        size_t spec_len = (size_t)(end - conversion);
+        if (spec_len >= sizeof(spec)) spec_len = sizeof(spec) - 1;
+        memcpy(spec, conversion, spec_len);
+        spec[spec_len] = '\0';
+
+        const LogArg* value = &record->args[arg++];
+        int written = 0;
+        switch (type) {
+            case LOG_ARG_INT:
+                if (length == LOG_LENGTH_LONG_LONG) written = snprintf(line + len, size - len, spec, value->i);
+                else if (length == LOG_LENGTH_LONG) written = snprintf(line + len, size - len, spec, (long)value->i);
+                else if (length == LOG_LENGTH_SIZE) written = snprintf(line + len, size - len, spec, (size_t)value->i);
+                else written = snprintf(line + len, size - len, spec, (int)value->i);
+                break;
+            case LOG_ARG_UINT:
+                if (length == LOG_LENGTH_LONG_LONG) written = snprintf(line + len, size - len, spec, value->u);
+                else if (length == LOG_LENGTH_LONG) written = snprintf(line + len, size - len, spec, (unsigned long)value->u);
+                else if (length == LOG_LENGTH_SIZE) written = snprintf(line + len, size - len, spec, (size_t)value->u);
+                else written = snprintf(line + len, size - len, spec, (unsigned int)value->u);
+                break;
+            case LOG_ARG_DOUBLE:
+                written = snprintf(line + len, size - len, spec, value->d);
+                break;
+            case LOG_ARG_STRING:
+                written = snprintf(line + len, size - len, spec, record->strings + value->string_offset);
+                break;
+            case LOG_ARG_POINTER:
+                written = snprintf(line + len, size - len, spec, value->p);
+                break;
+        }
+        if (written > 0) len += (size_t)written;
+    }
+
+    if (len > size - 1) len = size - 1;
+    return len;
+}
+
+// Write out everything queued; returns the number of records written
+static size_t log_drain(void) {
+    static char line[LOG_LINE_SIZE];
+    size_t tail = atomic_load_explicit(&g_log.tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&g_log.head, memory_order_acquire);
+    size_t written = 0;
+
+    while (tail != head) {
+        const LogRecord* record = &g_log.records[tail & (LOG_RING_SIZE - 1)];
+        size_t len = format_record(record, line, sizeof(line));
+        fwrite(line, 1, len, stdout);
+        tail++;
+        written++;
+        if (tail == head) {
+            atomic_store_explicit(&g_log.tail, tail, memory_order_release);
+            head = atomic_load_explicit(&g_log.head, memory_order_acquire);
+        }
+    }
+
+    if (written > 0) fflush(stdout);
+    return written;
+}
+
+static void log_idle_sleep(void) {
+#ifdef _WIN32
+    Sleep(LOG_IDLE_SLEEP_MS);
+#else
+    struct timespec ts = {0, LOG_IDLE_SLEEP_MS * 1000000L};
+    nanosleep(&ts, NULL);
+#endif
+}
+
+#ifdef _WIN32
+static DWORD WINAPI log_thread_main(LPVOID arg) {
+#else
+static void* log_thread_main(void* arg) {
+#endif
+    (void)arg;
+    while (atomic_load_explicit(&g_log.running, memory_order_acquire)) {
+        if (log_drain() == 0) log_idle_sleep();
+    }
+    log_drain();  // Whatever was queued before shutdown
+    return 0;
+}
+
+void log_init(void) {
+    g_log.records = mem_alloc(LOG_RING_SIZE * sizeof(LogRecord));
+    if (g_log.records == NULL) {
+        fprintf(stderr, "Failed to allocate log ring!\n");
+        exit(1);
+    }
+    memset(g_log.records, 0, LOG_RING_SIZE * sizeof(LogRecord));  // Fault the pages in now, not mid-tick
+    atomic_store(&g_log.head, 0);
+    atomic_store(&g_log.tail, 0);
+    g_log.tail_cache = 0;
+    atomic_store(&g_log.dropped, 0);
+    atomic_store(&g_log.running, true);
+
+#ifdef _WIN32
+    g_log.thread = CreateThread(NULL, 0, log_thread_main, NULL, 0, NULL);
+    bool started = g_log.thread != NULL;
+#else
+    bool started = pthread_create(&g_log.thread, NULL, log_thread_main, NULL) == 0;
+#endif
+    if (!started) {
+        fprintf(stderr, "Failed to start log thread!\n");
+        exit(1);
+    }
+}
+
+void log_shutdown(void) {
+    if (g_log.records == NULL) return;
+
+    atomic_store_explicit(&g_log.running, false, memory_order_release);
+#ifdef _WIN32
+    WaitForSingleObject(g_log.thread, INFINITE);
+    CloseHandle(g_log.thread);
+#else
+    pthread_join(g_log.thread, NULL);
+#endif
+    mem_free(g_log.records);
+    g_log.records = NULL;
+}
+
+void log_write(int level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    // Not started (tools and benchmarks that link the server code): write directly
+    if (g_log.records == NULL) {
+        fputs(level_prefix[level], stdout);
+        vfprintf(stdout, format, args);
+        va_end(args);
+        return;
+    }
+
+    // Only re-read the consumer's tail when the ring looks full
+    size_t head = atomic_load_explicit(&g_log.head, memory_order_relaxed);
+    if (head - g_log.tail_cache == LOG_RING_SIZE) {
+        g_log.tail_cache = atomic_load_explicit(&g_log.tail, memory_order_acquire);
+        if (head - g_log.tail_cache == LOG_RING_SIZE) {
+            atomic_fetch_add_explicit(&g_log.dropped, 1, memory_order_relaxed);
+            va_end(args);
+            return;
+        }
+    }
+
+    LogRecord* record = &g_log.records[head & (LOG_RING_SIZE - 1)];
+    record->format = format;
+    record->level = (uint8_t)level;
+    record->arg_count = 0;
+    size_t string_used = 0;
+
+    const char* p = format;
+    const char* end;
+    bool has_arg;
+    LogArgType type;
+    LogLength length;
+    while (record->arg_count < LOG_MAX_ARGS &&
+           (p = next_conversion(p, &end, &has_arg, &type, &length)) != NULL) {
+        p = end;
+        if (!has_arg) continue;
+
+        LogArg* value = &record->args[record->arg_count++];
+        switch (type) {
+            case LOG_ARG_INT:
+                if (length == LOG_LENGTH_LONG_LONG) value->i = va_arg(args, long long);
+                else if (length == LOG_LENGTH_LONG) value->i = va_arg(args, long);
+                else if (length == LOG_LENGTH_SIZE) value->i = (long long)va_arg(args, size_t);
+                else value->i = va_arg(args, int);
+                break;
+            case LOG_ARG_UINT:
+                if (length == LOG_LENGTH_LONG_LONG) value->u = va_arg(args, unsigned long long);
+                else if (length == LOG_LENGTH_LONG) value->u = va_arg(args, unsigned long);
+                else if (length == LOG_LENGTH_SIZE) value->u = va_arg(args, size_t);
+                else value->u = va_arg(args, unsigned int);
+                break;
+            case LOG_ARG_DOUBLE:
+                value->d = va_arg(args, double);
+                break;
+            case LOG_ARG_STRING: {
+                // Copy what fits; an exhausted buffer yields empty strings
+                const char* s = va_arg(args, const char*);
+                if (s == NULL) s = "(null)";
+                size_t room = LOG_STRING_BYTES - string_used;
+                size_t n = strlen(s);
+                if (room == 0) {
+                    value->string_offset = LOG_STRING_BYTES - 1;
+                    break;
+                }
+                if (n > room - 1) n = room - 1;
+                memcpy(record->strings + string_used, s, n);
+                record->strings[string_used + n] = '\0';
+                value->string_offset = string_used;
+                string_used += n + 1;
+                break;
+            }
+            case LOG_ARG_POINTER:
+                value->p = va_arg(args, const void*);
+                break;
+        }
+    }
+    va_end(args);
+
+    atomic_store_explicit(&g_log.head, head + 1, memory_order_release);
+}
+
+uint64_t log_dropped(void) {
+    return atomic_load_explicit(&g_log.dropped, memory_order_relaxed);
+}
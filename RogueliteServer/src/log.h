@@ -0,0 +1,58 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Asynchronous logger. The tick thread only copies a binary record (format
+// string pointer + raw arguments) into a lock-free single-producer ring;
+// a background thread formats and writes them. Logging never blocks: when
+// the ring is full the record is dropped and counted.
+//
+// Only one thread may log (the tick thread). Format strings must be string
+// literals: the pointer is the record's format ID and is read later. %s
+// arguments are copied (truncated to fit the record); '*' widths are not
+// supported.
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+
+// Levels below this compile to nothing (build with LOG_LEVEL=0 for debug output)
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#endif
+
+void log_init(void);
+void log_shutdown(void);                  // Writes everything queued, then stops the thread
+
+void log_write(int level, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+uint64_t log_dropped(void);               // Records lost to a full ring (total)
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) log_write(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) log_write(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) log_write(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#define LOG_ERROR(...) log_write(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif
@@ -1,13 +1,25 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 #include "game_loop.h"
 #include "network.h"
+#include "config.h"
+#include "log.h"
+#include "bench.h"
 
-#define SERVER_PORT 12345
-
-int main() {
-    srand((unsigned int)time(NULL));
+int main(int argc, char** argv) {
+    ServerConfig config;
+    config_set_defaults(&config);
+    if (!config_parse_args(&config, argc, argv)) {
+        return 1;
+    }
+    
+    // Headless benchmark: no banner, no sockets
+    if (config.bench_ticks > 0) {
+        log_init();
+        int result = bench_run(&config);
+        log_shutdown();
+        return result;
+    }
     
     printf("\n");
     printf("╔════════════════════════════════════════╗\n");
@@ -16,16 +28,20 @@ int main() {
     printf("╚════════════════════════════════════════╝\n");
     printf("\n");
     
+    // Everything from here on logs through the background writer
+    log_init();
+    
     // Initialize network
-    SOCKET sock = network_init(SERVER_PORT);
+    SOCKET sock = network_init(config.port);
     if (sock == INVALID_SOCKET) {
+        log_shutdown();
         printf("Failed to initialize network\n");
         return 1;
     }
     
     // Initialize game
     GameState game;
-    game_init(&game, sock);
+    game_init(&game, sock, &config);
     
     // Run game loop (infinite)
     game_run_networked(&game);
@@ -33,6 +49,7 @@ int main() {
     // Cleanup
     game_cleanup(&game);
     network_cleanup(sock);
+    log_shutdown();
     
     return 0;
 }
\ No newline at end of file
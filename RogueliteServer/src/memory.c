@@ -0,0 +1,26 @@
+#include "memory.h"
+#include <stdlib.h>
+
+static AllocStats g_stats;
+
+void* mem_alloc(size_t size) {
+    g_stats.allocs++;
+    g_stats.bytes += size;
+    return malloc(size);
+}
+
+void* mem_realloc(void* ptr, size_t size) {
+    g_stats.allocs++;
+    g_stats.bytes += size;
+    return realloc(ptr, size);
+}
+
+void mem_free(void* ptr) {
+    if (ptr == NULL) return;
+    g_stats.frees++;
+    free(ptr);
+}
+
+AllocStats mem_get_stats(void) {
+    return g_stats;
+}
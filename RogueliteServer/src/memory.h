@@ -0,0 +1,22 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Counting wrappers around malloc/realloc/free.
+// All server heap traffic goes through these so the game loop can check
+// that a steady-state tick performs zero allocations.
+void* mem_alloc(size_t size);
+void* mem_realloc(void* ptr, size_t size);
+void mem_free(void* ptr);
+
+typedef struct {
+    uint64_t allocs;     // mem_alloc + mem_realloc calls
+    uint64_t frees;      // mem_free calls (non-NULL)
+    uint64_t bytes;      // Total bytes requested
+} AllocStats;
+
+AllocStats mem_get_stats(void);
+
+#endif
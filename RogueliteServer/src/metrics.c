@@ -0,0 +1,55 @@
+#include "metrics.h"
+#include "memory.h"
+#include "log.h"
+
+void metrics_collect(const GameState* game, uint16_t first_client, StatsMessage* msg) {
+    msg->tick = (uint32_t)game->tick_count;
+    msg->current_wave = (uint8_t)game->current_wave;
+    msg->client_count = (uint16_t)game->client_count;
+
+    PhaseSummary tick = profiler_tick_summary(&game->profiler);
+    msg->profile_ticks = (uint32_t)game->profiler.tick.total;
+    msg->tick_p50_us = (uint32_t)(tick.p50_ns / 1000);
+    msg->tick_p99_us = (uint32_t)(tick.p99_ns / 1000);
+    msg->tick_max_us = (uint32_t)(tick.max_ns / 1000);
+    msg->tick_overruns = (uint32_t)game->profiler.overruns;
+
+    // Projectiles live in the pool, not the entity manager
+    const EntityManager* em = &game->entity_manager;
+    msg->entity_counts[ENTITY_TYPE_PLAYER] = 0;
+    msg->entity_counts[ENTITY_TYPE_ENEMY] = 0;
+    for (size_t i = 0; i < em->count; i++) {
+        EntityType type = em->entities[i].type;
+        if (em->entities[i].active && type != ENTITY_TYPE_PROJECTILE) {
+            msg->entity_counts[type]++;
+        }
+    }
+    msg->entity_counts[ENTITY_TYPE_PROJECTILE] = (uint32_t)game->projectiles.count;
+
+    msg->inputs_dropped = (uint32_t)game->inputs.dropped;
+    msg->projectiles_dropped = (uint32_t)game->projectiles.dropped;
+    msg->log_dropped = (uint32_t)log_dropped();
+
+    AllocStats allocs = mem_get_stats();
+    msg->heap_allocs = allocs.allocs;
+    msg->heap_frees = allocs.frees;
+    msg->heap_bytes = allocs.bytes;
+    msg->tick_allocs = (uint32_t)game->tick_allocs;
+
+    // One page of connected clients
+    int slot = first_client;
+    msg->client_records = 0;
+    for (; slot < game->config.max_clients && msg->client_records < msg->client_capacity; slot++) {
+        const NetworkClient* client = &game->clients[slot];
+        if (!client->connected) continue;
+
+        ClientStats* stats = &msg->clients[msg->client_records++];
+        stats->player_id = client->player_id;
+        stats->rtt_us = client->rtt_us;
+        stats->bytes_sent = client->bytes_sent;
+        stats->bytes_received = client->bytes_received;
+        stats->packets_sent = client->packets_sent;
+        stats->packets_received = client->packets_received;
+    }
+    msg->next_client = (slot < game->config.max_clients) ? (uint16_t)slot : 0;
+}
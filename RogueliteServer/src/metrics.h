@@ -0,0 +1,12 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "game_loop.h"
+#include "protocol.h"
+
+// Fill a STATS reply from live game state: header fields, plus connected
+// clients from slot first_client on (as many as msg->client_capacity
+// allows). Read-only; called on the game thread between ticks.
+void metrics_collect(const GameState* game, uint16_t first_client, StatsMessage* msg);
+
+#endif
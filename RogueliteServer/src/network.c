@@ -1,14 +1,26 @@
+#ifndef _WIN32
+#define _GNU_SOURCE  // ppoll
+#endif
 #include "network.h"
-#include <stdio.h>
+#include "timing.h"
+#include "memory.h"
+#include "log.h"
+#include "metrics.h"
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <float.h>
+#include <errno.h>
 
 #ifdef _WIN32
 #include <winsock2.h>
 #define close closesocket
 #else
+#include <arpa/inet.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <poll.h>
+#include <time.h>
 #define closesocket close
 #endif
 
@@ -19,7 +31,7 @@ SOCKET network_init(int port)
     WSADATA wsa;
     if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0)
     {
-        printf("WSAStartup failed\n");
+        LOG_ERROR("WSAStartup failed\n");
         return INVALID_SOCKET;
     }
 #endif
@@ -28,7 +40,7 @@ SOCKET network_init(int port)
     SOCKET sock = socket(AF_INET, SOCK_DGRAM, 0);
     if (sock == INVALID_SOCKET)
     {
-        printf("Failed to create socket\n");
+        LOG_ERROR("Failed to create socket\n");
         return INVALID_SOCKET;
     }
 
@@ -41,7 +53,7 @@ SOCKET network_init(int port)
 
     if (bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
     {
-        printf("Bind failed\n");
+        LOG_ERROR("Bind failed\n");
         closesocket(sock);
         return INVALID_SOCKET;
     }
@@ -55,266 +67,813 @@ SOCKET network_init(int port)
     fcntl(sock, F_SETFL, flags | O_NONBLOCK);
 #endif
 
-    printf("Network initialized on port %d\n", port);
+    LOG_INFO("Network initialized on port %d\n", port);
     return sock;
 }
 
-// Compare addresses (helper function)
-static bool addr_equal(struct sockaddr_in *a, struct sockaddr_in *b)
+// Find or create client (O(1) hash lookup on IP:port)
+NetworkClient *network_find_or_create_client(GameState *game, struct sockaddr_in *addr)
 {
-    return a->sin_addr.s_addr == b->sin_addr.s_addr &&
-           a->sin_port == b->sin_port;
+    // Check if client already exists
+    int slot = client_table_find(&game->client_lookup, addr);
+    if (slot >= 0)
+    {
+        return &game->clients[slot];
+    }
+
+    // Take a free slot
+    if (game->free_client_count == 0)
+    {
+        LOG_WARN("Server full! Cannot accept more clients.\n");
+        return NULL;
+    }
+    int i = game->free_client_slots[--game->free_client_count];
+    client_table_insert(&game->client_lookup, addr, i);
+
+    NetworkClient *client = &game->clients[i];
+    client->addr = *addr;
+    client->connected = true;
+    client->last_packet_time = timing_now_seconds();
+    client->kills = 0;
+    client->player_name[0] = '\0';
+    client->name_tick = 0;
+    client->rtt_us = 0;
+    client->bytes_sent = 0;
+    client->bytes_received = 0;
+    client->packets_sent = 0;
+    client->packets_received = 0;
+    snapshot_ring_reset(&client->snapshots);  // New session: next state is a full one
+    priority_list_reset(&client->priorities);
+    game->client_count++;
+
+    // Spawn player entity on open floor
+    Vector2 spawn_pos = dungeon_random_spawn(&game->dungeon, &game->rng);
+    // Player appears at the end-of-tick sync point; the ID is valid now
+    client->player_id = entity_spawn(&game->entity_manager, ENTITY_TYPE_PLAYER,
+                                     spawn_pos, vector2_create(0.0f, 0.0f),
+                                     0, 0.0f);
+    client->view_x = spawn_pos.x;
+    client->view_y = spawn_pos.y;
+
+    LOG_INFO("New client connected: %s:%d (Player ID: %u)\n",
+             inet_ntoa(addr->sin_addr),
+             ntohs(addr->sin_port),
+             client->player_id);
+
+    return client;
 }
 
-// Find or create client
-NetworkClient *network_find_or_create_client(GameState *game, struct sockaddr_in *addr)
+// Remove client and release its slot
+void network_remove_client(GameState *game, NetworkClient *client)
 {
-    // Check if client already exists
-    for (int i = 0; i < MAX_CLIENTS; i++)
+    if (!client->connected)
+        return;
+
+    // Remove player entity (at the end-of-tick sync point)
+    entity_despawn(&game->entity_manager, client->player_id);
+
+    client_table_remove(&game->client_lookup, &client->addr);
+    game->free_client_slots[game->free_client_count++] = (int)(client - game->clients);
+
+    client->connected = false;
+    game->client_count--;
+}
+
+// Handle one datagram
+static void network_handle_packet(GameState *game, const uint8_t *buffer, int recv_len,
+                                  struct sockaddr_in *client_addr)
+{
+    // Empty datagrams carry no type (the batch slot still holds an older one)
+    if (recv_len < 1)
+        return;
+
+    // Get message type
+    uint8_t msg_type = buffer[0];
+
+    // Metrics queries aren't sessions: only accepted from this machine,
+    // and answered when the loop has idle time
+    if (msg_type == MSG_STATS_REQUEST)
+    {
+        uint16_t first_client;
+        bool local = (ntohl(client_addr->sin_addr.s_addr) >> 24) == 127;
+        if (!local || game->stats_request_count >= STATS_REQUEST_QUEUE ||
+            deserialize_stats_request(buffer, recv_len, &first_client) < 0)
+            return;
+
+        StatsRequest *request = &game->stats_requests[game->stats_request_count++];
+        request->addr = *client_addr;
+        request->first_client = first_client;
+        return;
+    }
+
+    // Find or create client
+    NetworkClient *client = network_find_or_create_client(game, client_addr);
+    if (!client)
+        return;
+
+    client->last_packet_time = timing_now_seconds();
+    client->packets_received++;
+    client->bytes_received += (uint64_t)recv_len;
+
+    // Handle message
+    if (msg_type == MSG_CONNECT)
+    {
+        ConnectMessage msg;
+        if (deserialize_connect(buffer, recv_len, &msg) < 0)
+            return;
+        
+        // NEW: Store player name
+        strncpy(client->player_name, msg.player_name, 31);
+        client->player_name[31] = '\0';  // Ensure null-terminated
+        client->name_tick = (uint32_t)game->tick_count + 1;  // (Re)send from the next state on
+        
+        LOG_INFO("Player '%s' connected (assigned ID: %u)\n", msg.player_name, client->player_id);
+        
+        // Send WELCOME message with their player ID and the dungeon seed
+        uint8_t welcome_buffer[WELCOME_SIZE];
+        uint32_t dungeon_seed = game->dungeon.seed;
+        welcome_buffer[0] = MSG_WELCOME;  // Message type
+        welcome_buffer[1] = (client->player_id >> 24) & 0xFF;  // Player ID (big-endian)
+        welcome_buffer[2] = (client->player_id >> 16) & 0xFF;
+        welcome_buffer[3] = (client->player_id >> 8) & 0xFF;
+        welcome_buffer[4] = client->player_id & 0xFF;
+        welcome_buffer[5] = (dungeon_seed >> 24) & 0xFF;       // Dungeon seed (big-endian)
+        welcome_buffer[6] = (dungeon_seed >> 16) & 0xFF;
+        welcome_buffer[7] = (dungeon_seed >> 8) & 0xFF;
+        welcome_buffer[8] = dungeon_seed & 0xFF;
+        
+        sendto(game->socket, (char*)welcome_buffer, WELCOME_SIZE, 0,
+               (struct sockaddr*)&client->addr, sizeof(client->addr));
+        client->packets_sent++;
+        client->bytes_sent += WELCOME_SIZE;
+        
+        LOG_INFO("Sent WELCOME to client with player ID %u (dungeon seed %u)\n",
+                 client->player_id, dungeon_seed);
+    }
+    else if (msg_type == MSG_INPUT)
     {
-        if (game->clients[i].connected && addr_equal(&game->clients[i].addr, addr))
+        // Decode now; the next tick applies it
+        InputQueue *queue = &game->inputs;
+        if (queue->count >= INPUT_QUEUE_CAPACITY)
         {
-            return &game->clients[i];
+            queue->dropped++;
+            return;
         }
-    }
 
-    // Find empty slot
-    for (int i = 0; i < MAX_CLIENTS; i++)
+        // Only a complete message claims the slot (a truncated one would
+        // replay whatever input was last left there)
+        QueuedInput *queued = &queue->items[(queue->head + queue->count) % INPUT_QUEUE_CAPACITY];
+        if (deserialize_input(buffer, recv_len, &queued->input) < 0)
+            return;
+        queued->player_id = client->player_id;
+        queue->count++;
+    }
+    else if (msg_type == MSG_ACK)
     {
-        if (!game->clients[i].connected)
+        // Client has this state: future deltas can be encoded against it
+        uint32_t tick;
+        if (deserialize_ack(buffer, recv_len, &tick) < 0)
+            return;
+
+        // Round trip from building that state to its ACK, smoothed like TCP's SRTT (1/8 gain)
+        const ClientFrame *frame = snapshot_ring_ack(&client->snapshots, tick);
+        if (frame != NULL)
         {
-            game->clients[i].addr = *addr;
-            game->clients[i].connected = true;
-            game->clients[i].last_packet_time = game->total_time;
-            game->client_count++;
-
-            // Spawn player entity
-            Vector2 spawn_pos = vector2_create(400.0f + i * 50.0f, 300.0f);
-            Entity *player = entity_create(&game->entity_manager, ENTITY_TYPE_PLAYER, spawn_pos);
-            game->clients[i].player_id = player->id;
-
-            printf("New client connected: %s:%d (Player ID: %u)\n",
-                   inet_ntoa(addr->sin_addr),
-                   ntohs(addr->sin_port),
-                   player->id);
-
-            return &game->clients[i];
+            int64_t sample = (int64_t)((timing_now_ns() - frame->sent_ns) / 1000);
+            if (client->rtt_us == 0)
+                client->rtt_us = (uint32_t)sample;
+            else
+                client->rtt_us = (uint32_t)((int64_t)client->rtt_us + (sample - (int64_t)client->rtt_us) / 8);
         }
     }
+    else if (msg_type == MSG_DISCONNECT)
+    {
+        LOG_INFO("Client disconnected: %s:%d\n",
+                 inet_ntoa(client_addr->sin_addr),
+                 ntohs(client_addr->sin_port));
 
-    printf("Server full! Cannot accept more clients.\n");
-    return NULL;
+        network_remove_client(game, client);
+    }
 }
 
-// Receive and process packets
-void network_receive_packets(GameState *game, float delta_time)
+// Receive and process packets (one recvmmsg per RECV_BATCH_SIZE datagrams)
+void network_receive_packets(GameState *game)
 {
-    uint8_t buffer[MAX_PACKET_SIZE];
-    struct sockaddr_in client_addr;
-    socklen_t addr_len = sizeof(client_addr);
+    UdpBatch *batch = &game->recv_batch;
 
-    // Non-blocking receive (returns immediately if no data)
     while (1)
     {
-        // recvfrom reads data from the socket into the buffer.
-        // It also fills in client_addr with the sender's address and addr_len with the size of that address structure.
-        // If there are no packets to read, it returns -1 (or 0 on some platforms), which we check for to break out of the loop.
-        int recv_len = recvfrom(game->socket, (char *)buffer, sizeof(buffer), 0,
-                                (struct sockaddr *)&client_addr, &addr_len);
-
-        if (recv_len <= 0)
-            break; // No more packets
+        int received = udp_recv_batch(game->socket, batch);
 
-        // Get message type
-        uint8_t msg_type = buffer[0];
+        for (int i = 0; i < received; i++)
+        {
+            network_handle_packet(game, batch->packets[i].data, batch->packets[i].length,
+                                  &batch->packets[i].addr);
+        }
 
-        // Find or create client
-        NetworkClient *client = network_find_or_create_client(game, &client_addr);
-        if (!client)
-            continue;
+        if (received < batch->capacity)
+            break; // Socket drained
+    }
+}
 
-        client->last_packet_time = game->total_time;
+// Apply queued inputs in arrival order
+void network_apply_inputs(GameState *game, float delta_time)
+{
+    InputQueue *queue = &game->inputs;
 
-        // Handle message
-        if (msg_type == MSG_CONNECT)
+    while (queue->count > 0)
+    {
+        QueuedInput *queued = &queue->items[queue->head];
+        const InputMessage *msg = &queued->input;
+        queue->head = (queue->head + 1) % INPUT_QUEUE_CAPACITY;
+        queue->count--;
+
+        // Find player entity
+        EntityManager *em = &game->entity_manager;
+        Entity *player = entity_get_by_id(em, queued->player_id);
+        if (player)
         {
-            ConnectMessage msg;
-            deserialize_connect(buffer, recv_len, &msg);
-            
-            // NEW: Store player name
-            strncpy(client->player_name, msg.player_name, 31);
-            client->player_name[31] = '\0';  // Ensure null-terminated
-            
-            printf("Player '%s' connected (assigned ID: %u)\n", msg.player_name, client->player_id);
-            
-            // Send WELCOME message with their player ID
-            uint8_t welcome_buffer[16];
-            welcome_buffer[0] = MSG_WELCOME;  // Message type
-            welcome_buffer[1] = (client->player_id >> 24) & 0xFF;  // Player ID (big-endian)
-            welcome_buffer[2] = (client->player_id >> 16) & 0xFF;
-            welcome_buffer[3] = (client->player_id >> 8) & 0xFF;
-            welcome_buffer[4] = client->player_id & 0xFF;
-            
-            sendto(game->socket, (char*)welcome_buffer, 5, 0,
-                   (struct sockaddr*)&client->addr, sizeof(client->addr));
+            AIComponent *player_ai = entity_get_ai(em, player);
+            Vector2 player_pos = entity_get_position(em, player);
+
+            // Apply movement
+            Vector2 velocity = vector2_create(0, 0);
+
+            if (msg->keys & KEY_W)
+                velocity.y -= 100.0f;
+            if (msg->keys & KEY_S)
+                velocity.y += 100.0f;
+            if (msg->keys & KEY_A)
+                velocity.x -= 100.0f;
+            if (msg->keys & KEY_D)
+                velocity.x += 100.0f;
+
+            entity_set_velocity(em, player, velocity);
             
-            printf("Sent WELCOME to client with player ID %u\n", client->player_id);
-        }
-        else if (msg_type == MSG_INPUT)
-        {
-            InputMessage msg;
-            deserialize_input(buffer, recv_len, &msg);
+            // NEW: Calculate player rotation (face mouse)
+            Vector2 mouse_pos = vector2_create(msg->mouse_x, msg->mouse_y);
+            Vector2 to_mouse = vector2_subtract(mouse_pos, player_pos);
+            player->rotation = atan2f(to_mouse.y, to_mouse.x);  // atan2(y, x) gives angle in radians
 
-            // Find player entity
-            Entity *player = entity_get_by_id(&game->entity_manager, client->player_id);
-            if (player)
+            // NEW: Handle shooting
+            if (msg->keys & KEY_SPACE)
             {
-                // Apply movement
-                Vector2 velocity = vector2_create(0, 0);
-
-                if (msg.keys & KEY_W)
-                    velocity.y -= 100.0f;
-                if (msg.keys & KEY_S)
-                    velocity.y += 100.0f;
-                if (msg.keys & KEY_A)
-                    velocity.x -= 100.0f;
-                if (msg.keys & KEY_D)
-                    velocity.x += 100.0f;
-
-                player->velocity = velocity;
-                
-                // NEW: Calculate player rotation (face mouse)
-                Vector2 mouse_pos = vector2_create(msg.mouse_x, msg.mouse_y);
-                Vector2 to_mouse = vector2_subtract(mouse_pos, player->position);
-                player->rotation = atan2f(to_mouse.y, to_mouse.x);  // atan2(y, x) gives angle in radians
-
-                // NEW: Handle shooting
-                if (msg.keys & KEY_SPACE)
+                // Check cooldown (prevent spam)
+                if (player_ai->attack_cooldown <= 0.0f)
                 {
-                    // Check cooldown (prevent spam)
-                    if (player->ai.attack_cooldown <= 0.0f)
-                    {
-                        // Calculate direction to mouse
-                        Vector2 mouse_pos = vector2_create(msg.mouse_x, msg.mouse_y);
-                        Vector2 direction = vector2_subtract(mouse_pos, player->position);
+                    // Calculate direction to mouse
+                    Vector2 mouse_pos = vector2_create(msg->mouse_x, msg->mouse_y);
+                    Vector2 direction = vector2_subtract(mouse_pos, player_pos);
 
-                        // Normalize direction
-                        float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
-                        if (length > 0.0f)
+                    // Normalize direction
+                    float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
+                    if (length > 0.0f)
+                    {
+                        direction.x /= length;
+                        direction.y /= length;
+
+                        // Spawn projectile 20px away from player (avoid self-collision)
+                        Vector2 projectile_pos;
+                        projectile_pos.x = player_pos.x + direction.x * 20.0f;
+                        projectile_pos.y = player_pos.y + direction.y * 20.0f;
+
+                        uint32_t projectile_id = projectile_spawn(&game->projectiles, projectile_pos,
+                                                                  vector2_multiply(direction, 300.0f), // Fast projectile
+                                                                  player->id,         // Track who shot it
+                                                                  player->rotation);  // Face same as player
+                        if (projectile_id)
                         {
-                            direction.x /= length;
-                            direction.y /= length;
-
-                            // Spawn projectile 20px away from player (avoid self-collision)
-                            Vector2 projectile_pos;
-                            projectile_pos.x = player->position.x + direction.x * 20.0f;
-                            projectile_pos.y = player->position.y + direction.y * 20.0f;
-
-                            Entity *projectile = entity_create(&game->entity_manager,
-                                                               ENTITY_TYPE_PROJECTILE,
-                                                               projectile_pos);
-                            if (projectile)
-                            {
-                                projectile->velocity.x = direction.x * 300.0f; // Fast projectile
-                                projectile->velocity.y = direction.y * 300.0f;
-                                projectile->owner_id = player->id;  // Track who shot it
-                                projectile->rotation = player->rotation;  // Face same as player
-
-                                printf("Player %u fired projectile toward (%.1f, %.1f)\n",
-                                       client->player_id, msg.mouse_x, msg.mouse_y);
-                            }
-
-                            // Set cooldown (0.2 seconds = 5 shots/sec)
-                            player->ai.attack_cooldown = 0.2f;
+                            LOG_DEBUG("Player %u fired projectile toward (%.1f, %.1f)\n",
+                                      queued->player_id, msg->mouse_x, msg->mouse_y);
                         }
+
+                        // Set cooldown (0.2 seconds = 5 shots/sec)
+                        player_ai->attack_cooldown = 0.2f;
                     }
                 }
+            }
 
-                // Update cooldown
-                if (player->ai.attack_cooldown > 0.0f)
-                {
-                    player->ai.attack_cooldown -= delta_time;
-                }
+            // Update cooldown
+            if (player_ai->attack_cooldown > 0.0f)
+            {
+                player_ai->attack_cooldown -= delta_time;
             }
         }
-        else if (msg_type == MSG_DISCONNECT)
+    }
+}
+
+// Metrics requests stay queued while less than this remains before a tick
+#define STATS_MIN_IDLE_NS 1000000ull
+
+// Answer queued metrics requests
+static void network_answer_stats(GameState *game)
+{
+    uint8_t buffer[MAX_PACKET_SIZE];
+    ClientStats clients[STATS_MAX_CLIENTS];
+    StatsMessage msg;
+    msg.clients = clients;
+    msg.client_capacity = STATS_MAX_CLIENTS;
+
+    for (int i = 0; i < game->stats_request_count; i++)
+    {
+        StatsRequest *request = &game->stats_requests[i];
+        metrics_collect(game, request->first_client, &msg);
+        int size = serialize_stats(&msg, buffer, sizeof(buffer));
+        if (size > 0)
+            sendto(game->socket, (char*)buffer, size, 0,
+                   (struct sockaddr*)&request->addr, sizeof(request->addr));
+    }
+    game->stats_request_count = 0;
+}
+
+// Idle until the deadline, handling packets the moment they arrive
+void network_wait(GameState *game, uint64_t deadline_ns)
+{
+    while (1)
+    {
+        uint64_t now = timing_now_ns();
+        if (now >= deadline_ns)
+            break;
+        uint64_t remaining = deadline_ns - now;
+
+        // Metrics only use time the tick doesn't need
+        if (game->stats_request_count > 0 && remaining > STATS_MIN_IDLE_NS)
         {
-            printf("Client disconnected: %s:%d\n",
-                   inet_ntoa(client_addr.sin_addr),
-                   ntohs(client_addr.sin_port));
+            network_answer_stats(game);
+            continue;
+        }
 
-            // Remove player entity
-            entity_destroy(&game->entity_manager, client->player_id);
+#ifdef _WIN32
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(game->socket, &readable);
+        struct timeval timeout;
+        timeout.tv_sec = (long)(remaining / NS_PER_SECOND);
+        timeout.tv_usec = (long)((remaining % NS_PER_SECOND) / 1000);
+        int ready = select(0, &readable, NULL, NULL, &timeout);
+#else
+        struct pollfd pfd;
+        pfd.fd = game->socket;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        struct timespec timeout;
+        timeout.tv_sec = (time_t)(remaining / NS_PER_SECOND);
+        timeout.tv_nsec = (long)(remaining % NS_PER_SECOND);
+        int ready = ppoll(&pfd, 1, &timeout, NULL);
+#endif
 
-            client->connected = false;
-            game->client_count--;
+        if (ready > 0)
+        {
+            game->socket_wakeups++;
+            uint64_t start = timing_now_ns();
+            network_receive_packets(game);
+            profiler_add_receive(&game->profiler, timing_now_ns() - start);
+        }
+        else if (ready < 0)
+        {
+            // A signal (e.g. SIGUSR1 for a profile) just ends this wait early;
+            // SA_RESTART never restarts ppoll
+#ifdef _WIN32
+            if (WSAGetLastError() == WSAEINTR)
+                continue;
+#else
+            if (errno == EINTR)
+                continue;
+#endif
+            // Real error: fall back to a plain sleep
+            timing_sleep_until_ns(deadline_ns);
+            break;
         }
     }
+
+    // Anything that landed right at the deadline goes into this tick too
+    uint64_t start = timing_now_ns();
+    network_receive_packets(game);
+    profiler_add_receive(&game->profiler, timing_now_ns() - start);
 }
 
-// Broadcast game state to all clients
-void network_broadcast_state(GameState *game)
+// Known entities beyond this fraction of the view radius are updated only
+// every FAR_UPDATE_INTERVAL ticks (staggered by ID); entering and leaving
+// relevance is always sent right away.
+#define NEAR_VIEW_FRACTION 0.75f
+#define FAR_UPDATE_INTERVAL 4
+
+static int compare_entity_id(const void *a, const void *b)
+{
+    uint32_t ia = ((const EntityState *)a)->entity_id;
+    uint32_t ib = ((const EntityState *)b)->entity_id;
+    return (ia > ib) - (ia < ib);
+}
+
+// Player IDs to sort client slots by (qsort has no context pointer)
+static const NetworkClient *sort_clients;
+
+static int compare_client_player_id(const void *a, const void *b)
+{
+    uint32_t ia = sort_clients[*(const int *)a].player_id;
+    uint32_t ib = sort_clients[*(const int *)b].player_id;
+    return (ia > ib) - (ia < ib);
+}
+
+// Append one entity to this tick's world state (grow-only)
+static void world_push(GameState *game, const EntityState *es)
+{
+    if (game->world_count >= game->world_capacity)
+    {
+        size_t new_capacity = game->world_capacity * 2;
+        EntityState *grown = mem_realloc(game->world_state, new_capacity * sizeof(EntityState));
+        if (grown == NULL)
+            return;
+        game->world_state = grown;
+        game->world_capacity = new_capacity;
+    }
+    game->world_state[game->world_count++] = *es;
+}
+
+// Gather this tick's entities, sorted by ID
+static void network_build_world_state(GameState *game)
 {
-    StateMessage state;
-    state.tick = game->tick_count;
-    state.entity_count = 0;
+    game->world_count = 0;
 
-    // Pack entities into state message
-    for (size_t i = 0; i < game->entity_manager.count && state.entity_count < 32; i++)
+    EntityManager *em = &game->entity_manager;
+    for (size_t i = 0; i < em->count; i++)
     {
-        Entity *e = &game->entity_manager.entities[i];
+        Entity *e = &em->entities[i];
         if (!e->active)
             continue;
-EntityState *es = &state.entities[state.entity_count++];
-        es->entity_id = e->id;
-        es->entity_type = e->type;
-        es->x = e->position.x;
-        es->y = e->position.y;
-        es->health = e->health;
-        es->max_health = e->max_health;
-        es->rotation = e->rotation;  // NEW: Add rotation
-        es->active = e->active;
+        EntityState es;
+        es.entity_id = e->id;
+        es.entity_type = e->type;
+        es.x = em->pos_x[i];
+        es.y = em->pos_y[i];
+        es.health = e->health;
+        es.max_health = e->max_health;
+        es.rotation = e->rotation;
+        es.active = true;
+        world_push(game, &es);
+    }
+
+    // Projectiles from the pool
+    ProjectilePool *pool = &game->projectiles;
+    for (size_t i = 0; i < pool->count; i++)
+    {
+        if (!pool->active[i])
+            continue;
+        EntityState es;
+        es.entity_id = pool->id[i];
+        es.entity_type = ENTITY_TYPE_PROJECTILE;
+        es.x = pool->pos_x[i];
+        es.y = pool->pos_y[i];
+        es.health = 1;
+        es.max_health = 1;
+        es.rotation = pool->rotation[i];
+        es.active = true;
+        world_push(game, &es);
+    }
+
+    qsort(game->world_state, game->world_count, sizeof(EntityState), compare_entity_id);
+
+    // Bucket by position for the per-client relevance queries
+    interest_grid_build(&game->interest, game->world_state, game->world_count);
+}
+
+// Distance from a client's view center
+static float view_distance(const NetworkClient *client, const EntityState *e)
+{
+    float dx = e->x - client->view_x;
+    float dy = e->y - client->view_y;
+    return sqrtf(dx * dx + dy * dy);
+}
+
+// Whether a known entity is due for an update this tick (far ones less often)
+static bool entity_update_due(const EntityState *e, float distance, float near_radius, uint32_t tick)
+{
+    if (distance <= near_radius)
+        return true;
+    return (tick + e->entity_id) % FAR_UPDATE_INTERVAL == 0;
+}
+
+// Room for one candidate per baseline + relevant entity (grow-only)
+static bool ensure_candidates(GameState *game, size_t needed)
+{
+    if (needed <= game->candidate_capacity)
+        return true;
+
+    size_t new_capacity = game->candidate_capacity;
+    while (new_capacity < needed)
+        new_capacity *= 2;
+
+    StateCandidate *candidates = mem_realloc(game->candidates, new_capacity * sizeof(StateCandidate));
+    if (candidates == NULL)
+        return false;
+    game->candidates = candidates;
+    uint32_t *order = mem_realloc(game->candidate_order, new_capacity * sizeof(uint32_t));
+    if (order == NULL)
+        return false;
+    game->candidate_order = order;
+    game->candidate_capacity = new_capacity;
+    return true;
+}
+
+// Candidates to rank (qsort has no context pointer)
+static const StateCandidate *sort_candidates;
+
+static int compare_candidate_priority(const void *a, const void *b)
+{
+    float pa = sort_candidates[*(const uint32_t *)a].priority;
+    float pb = sort_candidates[*(const uint32_t *)b].priority;
+    return (pa < pb) - (pa > pb);  // Highest first
+}
+
+// Pick which candidates fit this tick's byte budget, highest priority first
+static void select_candidates(GameState *game, NetworkClient *client, size_t count)
+{
+    StateCandidate *candidates = game->candidates;
+    uint32_t *order = game->candidate_order;
+    size_t ranked = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        candidates[i].send = false;
+        if (candidates[i].bits > 0)
+            order[ranked++] = (uint32_t)i;
     }
-    
-    // NEW: Add wave system data
-    state.current_wave = (uint8_t)game->current_wave;
-    state.wave_active = game->wave_active ? 1 : 0;
-    state.wave_countdown = game->wave_countdown;
-    
-    // NEW: Pack player names
-    state.player_count = 0;
-    for (int i = 0; i < MAX_CLIENTS && state.player_count < 4; i++) {
-        if (game->clients[i].connected) {
-            state.players[state.player_count].player_id = game->clients[i].player_id;
-            strncpy(state.players[state.player_count].name, game->clients[i].player_name, 31);
-            state.players[state.player_count].name[31] = '\0';
-            state.player_count++;
+
+    sort_candidates = candidates;
+    qsort(order, ranked, sizeof(uint32_t), compare_candidate_priority);
+
+    // Greedy fill: a big record that doesn't fit doesn't stop smaller ones
+    long budget_bits = (long)game->config.state_budget * 8;
+    for (size_t k = 0; k < ranked; k++)
+    {
+        StateCandidate *candidate = &candidates[order[k]];
+        if (candidate->bits <= budget_bits)
+        {
+            candidate->send = true;
+            budget_bits -= candidate->bits;
+        }
+        else
+        {
+            client->deferred_records++;
         }
     }
+}
 
-    // Serialize
-    uint8_t buffer[MAX_PACKET_SIZE];
-    int size = serialize_state(&state, buffer, sizeof(buffer));
+// Splits one client's STATE into fragments written straight into send buffers
+typedef struct
+{
+    GameState *game;
+    NetworkClient *client;
+    const StateMessage *header;
+    uint32_t baseline_tick;
+    StateWriter writer;
+    int index;              // Current fragment
+    uint32_t range_start;   // First ID the current fragment covers
+    bool players_only;      // Opened after the last entity: covers no IDs
+} StateFragmenter;
+
+// Next free send buffer (sends the batch first if it's full)
+static uint8_t *state_send_buffer(GameState *game)
+{
+    UdpBatch *batch = &game->send_batch;
+    if (batch->count == batch->capacity)
+        udp_send_batch(game->socket, batch);
+    return &game->send_buffers[batch->count * MAX_PACKET_SIZE];
+}
+
+static void fragment_open(StateFragmenter *f)
+{
+    uint8_t *buffer = state_send_buffer(f->game);
+    state_writer_begin(&f->writer, buffer, MAX_PACKET_SIZE, f->header,
+                       f->baseline_tick, (uint8_t)f->index);
+}
+
+// Finish the current fragment and queue it for sending
+static void fragment_close(StateFragmenter *f, uint32_t range_last, bool last)
+{
+    int size = f->players_only ? state_writer_finish(&f->writer, 1, 0, last)
+                               : state_writer_finish(&f->writer, f->range_start, range_last, last);
+
+    UdpBatch *batch = &f->game->send_batch;
+    UdpPacket *packet = &batch->packets[batch->count++];
+    packet->data = f->writer.buffer;
+    packet->length = size;
+    packet->addr = f->client->addr;
+    f->game->state_bytes_sent += (uint64_t)size;
+    f->client->state_bytes += (uint64_t)size;
+    f->client->bytes_sent += (uint64_t)size;
+    f->client->packets_sent++;
+}
 
-    if (size < 0)
+// Close the current fragment at range_last and continue in a new one
+// starting at next_start (false once the per-tick fragment limit is reached)
+static bool fragment_split(StateFragmenter *f, uint32_t range_last, uint32_t next_start)
+{
+    if (f->index + 1 >= STATE_MAX_FRAGMENTS)
+        return false;
+    fragment_close(f, range_last, false);
+    f->index++;
+    f->range_start = next_start;
+    fragment_open(f);
+    return true;
+}
+
+static bool fragment_entity(StateFragmenter *f, const EntityState *base, const EntityState *cur)
+{
+    if (state_writer_entity(&f->writer, base, cur))
+        return true;
+    return fragment_split(f, cur->entity_id - 1, cur->entity_id) && state_writer_entity(&f->writer, base, cur);
+}
+
+static bool fragment_remove(StateFragmenter *f, uint32_t entity_id)
+{
+    if (state_writer_remove(&f->writer, entity_id))
+        return true;
+    return fragment_split(f, entity_id - 1, entity_id) && state_writer_remove(&f->writer, entity_id);
+}
+
+static bool fragment_player(StateFragmenter *f, const PlayerInfo *info)
+{
+    if (state_writer_player(&f->writer, info))
+        return true;
+    if (!fragment_split(f, STATE_RANGE_ALL_LAST, STATE_RANGE_ALL_LAST))
+        return false;
+    // The fragment just closed took every remaining ID; this one has names only
+    f->players_only = true;
+    return state_writer_player(&f->writer, info);
+}
+
+// Encode one client's STATE against its last acked frame, recording what it will hold
+static void network_build_client_state(GameState *game, NetworkClient *client,
+                                       const StateMessage *header, int player_total)
+{
+    SnapshotRing *ring = &client->snapshots;
+    uint32_t tick = header->tick;
+    const ClientFrame *baseline = snapshot_ring_baseline(ring, tick);
+    ClientFrame *frame = snapshot_ring_begin(ring, tick);
+    frame->sent_ns = timing_now_ns();
+
+    StateFragmenter f;
+    f.game = game;
+    f.client = client;
+    f.header = header;
+    f.baseline_tick = baseline ? baseline->tick : 0;
+    f.index = 0;
+    f.range_start = STATE_RANGE_ALL_START;
+    f.players_only = false;
+    fragment_open(&f);
+
+    // Area of interest follows the player (stays put while it's dead)
+    Entity *player = entity_get_by_id(&game->entity_manager, client->player_id);
+    if (player != NULL)
     {
-        printf("Failed to serialize state\n");
-        return;
+        Vector2 position = entity_get_position(&game->entity_manager, player);
+        client->view_x = position.x;
+        client->view_y = position.y;
     }
 
-    // Send to all connected clients
-    for (int i = 0; i < MAX_CLIENTS; i++)
+    size_t relevant_count;
+    const uint32_t *relevant = interest_grid_query(&game->interest, game->world_state,
+                                                   client->view_x, client->view_y,
+                                                   game->config.view_radius, &relevant_count);
+    game->relevant_entities += relevant_count;
+    float near_radius = game->config.view_radius * NEAR_VIEW_FRACTION;
+
+    // Pass 1: merge baseline and relevant entities (both sorted by ID) into
+    // candidates. Entities entering relevance become creates, ones leaving
+    // (or dying) removes; priorities grow for everything the client is
+    // behind on.
+    const EntityState *world = game->world_state;
+    size_t base_count = baseline ? baseline->entity_count : 0;
+    size_t b = 0, c = 0, count = 0;
+    PriorityList *priorities = &client->priorities;
+
+    if (!ensure_candidates(game, base_count + relevant_count))
+        base_count = relevant_count = 0;  // Out of memory: send nothing new this tick
+    StateCandidate *candidates = game->candidates;
+    priority_list_begin(priorities);
+
+    while (b < base_count || c < relevant_count)
     {
-        if (game->clients[i].connected)
+        const EntityState *base = (b < base_count) ? &baseline->entities[b] : NULL;
+        const EntityState *cur = (c < relevant_count) ? &world[relevant[c]] : NULL;
+        StateCandidate *candidate = &candidates[count++];
+
+        if (cur == NULL || (base != NULL && base->entity_id < cur->entity_id))
+        {
+            // Gone or out of view: removes are tiny and always go first
+            candidate->base = base;
+            candidate->cur = NULL;
+            candidate->priority = FLT_MAX;
+            candidate->bits = (uint16_t)state_record_bits(DELTA_REMOVED, 0);
+            candidate->changed = true;
+            b++;
+            continue;
+        }
+
+        bool known = base != NULL && cur->entity_id == base->entity_id;
+        float distance = view_distance(client, cur);
+        int flags = state_entity_flags(known ? base : NULL, cur);
+        candidate->base = known ? base : NULL;
+        candidate->cur = cur;
+        candidate->priority = priority_list_get(priorities, cur->entity_id) +
+                              priority_weight(cur, client->player_id, distance,
+                                              game->config.view_radius);
+        candidate->changed = flags != 0;
+        candidate->bits = 0;
+        if (candidate->changed && (!known || entity_update_due(cur, distance, near_radius, tick)))
+            candidate->bits = (uint16_t)state_record_bits(flags, cur->max_health);
+        if (known)
+            b++;
+        c++;
+    }
+
+    // Pass 2: spend the budget on the highest priorities
+    select_candidates(game, client, count);
+
+    // Pass 3: write the chosen records in ID order. Everything else stays
+    // at its baseline value in the frame (or unknown, if new) and keeps
+    // its accumulated priority. Past the fragment limit the same applies.
+    for (size_t i = 0; i < count; i++)
+    {
+        StateCandidate *candidate = &candidates[i];
+        const EntityState *base = candidate->base;
+        const EntityState *cur = candidate->cur;
+
+        if (cur == NULL)
+        {
+            if (!candidate->send || !fragment_remove(&f, base->entity_id))
+                snapshot_frame_add_entity(frame, base);
+            continue;
+        }
+
+        bool up_to_date = !candidate->changed ||
+                          (candidate->send && fragment_entity(&f, base, cur));
+        if (up_to_date)
+            snapshot_frame_add_entity(frame, cur);
+        else if (base != NULL)
+            snapshot_frame_add_entity(frame, base);
+
+        // Up to date (or just sent): start accumulating again from zero
+        priority_list_set(priorities, cur->entity_id, up_to_date ? 0.0f : candidate->priority);
+    }
+    priority_list_end(priorities);
+
+    // Names the client doesn't have yet (or that changed since its baseline)
+    for (int p = 0; p < player_total; p++)
+    {
+        NetworkClient *owner = &game->clients[game->player_order[p]];
+        bool known = baseline != NULL &&
+                     owner->name_tick <= baseline->tick &&
+                     snapshot_frame_has_player(baseline, owner->player_id);
+
+        if (!known)
         {
-            // The sendto function is used to send the serialized state message to each connected client.
-            // It takes the socket, the buffer containing the serialized message, the size of that message,
-            // and the address of the client to send it to. The sizeof(game->clients[i].addr) specifies the size of the address structure.
-            sendto(game->socket, (char *)buffer, size, 0,
-                   (struct sockaddr *)&game->clients[i].addr,
-                   sizeof(game->clients[i].addr));
+            PlayerInfo info;
+            info.player_id = owner->player_id;
+            strncpy(info.name, owner->player_name, 31);
+            info.name[31] = '\0';
+            if (!fragment_player(&f, &info))
+                continue;  // Out of room; retried next tick
         }
+        snapshot_frame_add_player(frame, owner->player_id);
     }
+
+    fragment_close(&f, STATE_RANGE_ALL_LAST, true);
+}
+
+// Broadcast game state to all clients (one delta per client)
+void network_broadcast_state(GameState *game)
+{
+    network_build_world_state(game);
+
+    StateMessage header;
+    header.tick = (uint32_t)game->tick_count;
+    header.current_wave = (uint8_t)game->current_wave;
+    header.wave_active = game->wave_active ? 1 : 0;
+    header.wave_countdown = game->wave_countdown;
+
+    // Connected players in ID order (frames keep name lists sorted)
+    int max_clients = game->config.max_clients;
+    int player_total = 0;
+    for (int i = 0; i < max_clients; i++)
+    {
+        if (game->clients[i].connected)
+            game->player_order[player_total++] = i;
+    }
+    sort_clients = game->clients;
+    qsort(game->player_order, (size_t)player_total, sizeof(int), compare_client_player_id);
+
+    // Encode per client straight into the send buffers; they go out a
+    // batch at a time
+    for (int i = 0; i < max_clients; i++)
+    {
+        NetworkClient *client = &game->clients[i];
+        if (client->connected)
+            network_build_client_state(game, client, &header, player_total);
+    }
+
+    udp_send_batch(game->socket, &game->send_batch);
 }
 
 // Cleanup network
@@ -10,8 +10,17 @@ SOCKET network_init(int port);
 // Find or create client from address
 NetworkClient* network_find_or_create_client(GameState* game, struct sockaddr_in* addr);
 
-// Handle incoming packets
-void network_receive_packets(GameState* game, float delta_time);
+// End a client session (disconnect or timeout): despawn its player, free its slot
+void network_remove_client(GameState* game, NetworkClient* client);
+
+// Drain the socket: handle connects/disconnects, decode and queue inputs
+void network_receive_packets(GameState* game);
+
+// Idle until deadline_ns (timing_now_ns clock), receiving packets as they arrive
+void network_wait(GameState* game, uint64_t deadline_ns);
+
+// Apply every queued input to its player (tick step 1)
+void network_apply_inputs(GameState* game, float delta_time);
 
 // Broadcast game state to all clients
 void network_broadcast_state(GameState* game);
@@ -0,0 +1,103 @@
+#include "priority.h"
+#include "entity.h"
+#include "memory.h"
+#include <string.h>
+
+#define PRIORITY_INITIAL_CAPACITY 64
+
+// Type weights (per tick)
+#define PRIORITY_OWN_PLAYER 8.0f
+#define PRIORITY_PLAYER 4.0f
+#define PRIORITY_PROJECTILE 3.0f
+#define PRIORITY_ENEMY 1.0f
+#define PRIORITY_PROXIMITY_BOOST 3.0f   // Extra weight at distance 0, fading to none at the view radius
+
+void priority_list_init(PriorityList* list) {
+    memset(list, 0, sizeof(*list));
+}
+
+void priority_list_free(PriorityList* list) {
+    mem_free(list->ids);
+    mem_free(list->values);
+    mem_free(list->next_ids);
+    mem_free(list->next_values);
+    memset(list, 0, sizeof(*list));
+}
+
+void priority_list_reset(PriorityList* list) {
+    list->count = 0;
+    list->cursor = 0;
+    list->next_count = 0;
+}
+
+void priority_list_begin(PriorityList* list) {
+    list->cursor = 0;
+    list->next_count = 0;
+}
+
+float priority_list_get(PriorityList* list, uint32_t id) {
+    while (list->cursor < list->count && list->ids[list->cursor] < id) {
+        list->cursor++;
+    }
+    if (list->cursor < list->count && list->ids[list->cursor] == id) {
+        return list->values[list->cursor];
+    }
+    return 0.0f;
+}
+
+// Grow both buffers together (they swap every tick)
+static bool priority_list_grow(PriorityList* list) {
+    size_t new_capacity = list->capacity ? list->capacity * 2 : PRIORITY_INITIAL_CAPACITY;
+    uint32_t* ids = mem_realloc(list->ids, new_capacity * sizeof(uint32_t));
+    if (ids == NULL) return false;
+    list->ids = ids;
+    float* values = mem_realloc(list->values, new_capacity * sizeof(float));
+    if (values == NULL) return false;
+    list->values = values;
+    uint32_t* next_ids = mem_realloc(list->next_ids, new_capacity * sizeof(uint32_t));
+    if (next_ids == NULL) return false;
+    list->next_ids = next_ids;
+    float* next_values = mem_realloc(list->next_values, new_capacity * sizeof(float));
+    if (next_values == NULL) return false;
+    list->next_values = next_values;
+    list->capacity = new_capacity;
+    return true;
+}
+
+bool priority_list_set(PriorityList* list, uint32_t id, float value) {
+    if (list->next_count >= list->capacity && !priority_list_grow(list)) return false;
+    list->next_ids[list->next_count] = id;
+    list->next_values[list->next_count] = value;
+    list->next_count++;
+    return true;
+}
+
+void priority_list_end(PriorityList* list) {
+    uint32_t* ids = list->ids;
+    float* values = list->values;
+    list->ids = list->next_ids;
+    list->values = list->next_values;
+    list->next_ids = ids;
+    list->next_values = values;
+    list->count = list->next_count;
+    list->next_count = 0;
+    list->cursor = 0;
+}
+
+float priority_weight(const EntityState* entity, uint32_t own_player_id,
+                      float distance, float view_radius) {
+    float weight;
+    if (entity->entity_id == own_player_id) {
+        weight = PRIORITY_OWN_PLAYER;
+    } else if (entity->entity_type == ENTITY_TYPE_PLAYER) {
+        weight = PRIORITY_PLAYER;
+    } else if (entity->entity_type == ENTITY_TYPE_PROJECTILE) {
+        weight = PRIORITY_PROJECTILE;
+    } else {
+        weight = PRIORITY_ENEMY;
+    }
+
+    float closeness = 1.0f - distance / view_radius;
+    if (closeness < 0.0f) closeness = 0.0f;
+    return weight * (1.0f + PRIORITY_PROXIMITY_BOOST * closeness);
+}
@@ -0,0 +1,57 @@
+#ifndef PRIORITY_H
+#define PRIORITY_H
+
+#include "protocol.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Per-client priority accumulators, one per relevant entity, sorted by ID.
+// Each tick an entity isn't sent its priority grows by its weight; sending
+// it resets it to zero. Rebuilt every tick by a merge in ID order (lookups
+// and stores must come in ascending ID order), double-buffered so steady
+// state never allocates.
+typedef struct {
+    uint32_t* ids;
+    float* values;
+    size_t count;
+    size_t capacity;
+    size_t cursor;          // Read position for priority_list_get
+    uint32_t* next_ids;     // Being built this tick
+    float* next_values;
+    size_t next_count;
+} PriorityList;
+
+// One entity that may need a record this tick (in ID order)
+typedef struct {
+    const EntityState* base;    // What the client has (NULL = new to it)
+    const EntityState* cur;     // What it should have (NULL = remove)
+    float priority;             // Accumulated priority including this tick
+    uint16_t bits;              // Record size (0 = not sent this tick)
+    bool changed;               // Client is out of date on it
+    bool send;                  // Chosen to fit the budget
+} StateCandidate;
+
+void priority_list_init(PriorityList* list);
+void priority_list_free(PriorityList* list);
+void priority_list_reset(PriorityList* list);
+
+// Start rebuilding for a new tick
+void priority_list_begin(PriorityList* list);
+
+// Accumulated priority of 'id' from last tick (0 if it wasn't tracked)
+float priority_list_get(PriorityList* list, uint32_t id);
+
+// Store the accumulator for 'id' this tick; false if growing fails
+bool priority_list_set(PriorityList* list, uint32_t id, float value);
+
+// Swap in this tick's accumulators
+void priority_list_end(PriorityList* list);
+
+// Per-tick priority growth of an entity for one client: by type (own player
+// first, then players and projectiles, then enemies) and by proximity
+// (up to 4x at the client's position, 1x at the view radius)
+float priority_weight(const EntityState* entity, uint32_t own_player_id,
+                      float distance, float view_radius);
+
+#endif
@@ -0,0 +1,170 @@
+#define _POSIX_C_SOURCE 200809L  // SIGUSR1 under -std=c11
+#include "profiler.h"
+#include "timing.h"
+#include "log.h"
+#include <string.h>
+#include <signal.h>
+
+static const char* phase_names[PHASE_COUNT] = {
+    "receive", "timeouts", "input", "wave", "ai", "integrate",
+    "clamp", "collision", "sync", "broadcast", "status"
+};
+
+static volatile sig_atomic_t report_requested = 0;
+
+// Position of the highest set bit (value > 0)
+static int highest_bit(uint64_t value) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) bit++;
+    return bit;
+#endif
+}
+
+// Values below 2 * SUB_COUNT map to themselves; above that each power of
+// two gets SUB_COUNT buckets
+static int bucket_index(uint64_t value) {
+    if (value < 2 * HISTOGRAM_SUB_COUNT) return (int)value;
+    int magnitude = highest_bit(value);
+    if (magnitude > HISTOGRAM_MAX_MAGNITUDE) return HISTOGRAM_BUCKETS - 1;
+    int shift = magnitude - HISTOGRAM_SUB_BITS;
+    return shift * HISTOGRAM_SUB_COUNT + (int)(value >> shift);
+}
+
+// Largest value that maps to a bucket
+static uint64_t bucket_upper(int index) {
+    if (index < 2 * HISTOGRAM_SUB_COUNT) return (uint64_t)index;
+    int shift = index / HISTOGRAM_SUB_COUNT - 1;
+    uint64_t sub = (uint64_t)(index % HISTOGRAM_SUB_COUNT + HISTOGRAM_SUB_COUNT);
+    return ((sub + 1) << shift) - 1;
+}
+
+void histogram_reset(Histogram* h) {
+    memset(h, 0, sizeof(*h));
+}
+
+void histogram_record(Histogram* h, uint64_t value) {
+    h->counts[bucket_index(value)]++;
+    h->total++;
+    h->sum += value;
+    if (value > h->max) h->max = value;
+}
+
+uint64_t histogram_percentile(const Histogram* h, double percentile) {
+    if (h->total == 0) return 0;
+
+    // Rank of the sample we want (1-based, rounded up)
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)h->total + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > h->total) rank = h->total;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            uint64_t upper = bucket_upper(i);
+            return upper < h->max ? upper : h->max;
+        }
+    }
+    return h->max;
+}
+
+#ifndef _WIN32
+static void handle_report_signal(int sig) {
+    (void)sig;
+    report_requested = 1;
+}
+#endif
+
+void profiler_init(Profiler* p, uint64_t budget_ns) {
+    memset(p, 0, sizeof(*p));
+    p->budget_ns = budget_ns;
+    p->window_start = timing_now_ns();
+
+#ifndef _WIN32
+    // kill -USR1 <pid> prints a report at the end of the next tick
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_report_signal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, NULL);
+#endif
+}
+
+void profiler_add_receive(Profiler* p, uint64_t ns) {
+    p->receive_ns += ns;
+}
+
+void profiler_begin_tick(Profiler* p) {
+    uint64_t now = timing_now_ns();
+    histogram_record(&p->phases[PHASE_RECEIVE], p->receive_ns);
+    p->receive_ns = 0;
+    p->tick_start = now;
+    p->phase_start = now;
+}
+
+void profiler_end_phase(Profiler* p, ProfilePhase phase) {
+    uint64_t now = timing_now_ns();
+    histogram_record(&p->phases[phase], now - p->phase_start);
+    p->phase_start = now;
+}
+
+uint64_t profiler_end_tick(Profiler* p) {
+    uint64_t elapsed = timing_now_ns() - p->tick_start;
+    histogram_record(&p->tick, elapsed);
+    if (elapsed > p->budget_ns) p->overruns++;
+    return elapsed;
+}
+
+static PhaseSummary summarize(const Histogram* h) {
+    PhaseSummary summary;
+    summary.p50_ns = histogram_percentile(h, 50.0);
+    summary.p99_ns = histogram_percentile(h, 99.0);
+    summary.max_ns = h->max;
+    return summary;
+}
+
+PhaseSummary profiler_phase_summary(const Profiler* p, ProfilePhase phase) {
+    return summarize(&p->phases[phase]);
+}
+
+PhaseSummary profiler_tick_summary(const Profiler* p) {
+    return summarize(&p->tick);
+}
+
+const char* profiler_phase_name(ProfilePhase phase) {
+    return phase_names[phase];
+}
+
+bool profiler_report_requested(void) {
+    if (!report_requested) return false;
+    report_requested = 0;
+    return true;
+}
+
+void profiler_report(Profiler* p) {
+    uint64_t now = timing_now_ns();
+    LOG_INFO("=== PROFILE: %llu ticks in %.1fs - overruns %llu (budget %.2f ms) ===\n",
+             (unsigned long long)p->tick.total, (double)(now - p->window_start) / NS_PER_SECOND,
+             (unsigned long long)p->overruns, p->budget_ns / 1e6);
+
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        PhaseSummary s = profiler_phase_summary(p, (ProfilePhase)i);
+        LOG_INFO("  %-10s p50 %8.3f ms - p99 %8.3f ms - max %8.3f ms\n",
+                 phase_names[i], s.p50_ns / 1e6, s.p99_ns / 1e6, s.max_ns / 1e6);
+    }
+    PhaseSummary s = profiler_tick_summary(p);
+    LOG_INFO("  %-10s p50 %8.3f ms - p99 %8.3f ms - max %8.3f ms\n",
+             "tick", s.p50_ns / 1e6, s.p99_ns / 1e6, s.max_ns / 1e6);
+
+    // New window
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        histogram_reset(&p->phases[i]);
+    }
+    histogram_reset(&p->tick);
+    p->overruns = 0;
+    p->window_start = now;
+}
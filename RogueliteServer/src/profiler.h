@@ -0,0 +1,88 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Log-linear latency histogram (HDR style): 32 linear sub-buckets per
+// power of two, so any recorded value is within ~3% of its bucket.
+// Covers 0 ns to ~18 minutes; larger values land in the last bucket.
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_MAGNITUDE 40
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_MAGNITUDE - HISTOGRAM_SUB_BITS + 2) * HISTOGRAM_SUB_COUNT)
+
+typedef struct {
+    uint32_t counts[HISTOGRAM_BUCKETS];
+    uint64_t total;
+    uint64_t sum;
+    uint64_t max;
+} Histogram;
+
+void histogram_reset(Histogram* h);
+void histogram_record(Histogram* h, uint64_t value);
+
+// Value at or below which 'percentile' (0-100) of the samples fall
+// (bucket upper bound, capped at the exact max)
+uint64_t histogram_percentile(const Histogram* h, double percentile);
+
+// Tick phases, in game_tick order. Receive is the packet work done while
+// waiting for the tick (summed since the previous tick).
+typedef enum {
+    PHASE_RECEIVE,
+    PHASE_TIMEOUTS,
+    PHASE_INPUT,
+    PHASE_WAVE,
+    PHASE_AI,
+    PHASE_INTEGRATE,
+    PHASE_CLAMP,
+    PHASE_COLLISION,
+    PHASE_SYNC,
+    PHASE_BROADCAST,
+    PHASE_STATUS,
+    PHASE_COUNT
+} ProfilePhase;
+
+typedef struct {
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} PhaseSummary;
+
+// Per-phase and whole-tick histograms since the last report. One clock
+// read per phase boundary; cheap enough to leave on.
+typedef struct {
+    Histogram phases[PHASE_COUNT];
+    Histogram tick;
+    uint64_t budget_ns;         // Tick length: longer ticks are overruns
+    uint64_t overruns;
+    uint64_t tick_start;
+    uint64_t phase_start;
+    uint64_t receive_ns;        // Accumulated between ticks
+    uint64_t window_start;      // When the current report window began
+} Profiler;
+
+void profiler_init(Profiler* p, uint64_t budget_ns);
+
+// Time spent handling packets outside the tick (counted as PHASE_RECEIVE)
+void profiler_add_receive(Profiler* p, uint64_t ns);
+
+void profiler_begin_tick(Profiler* p);
+
+// End 'phase' now; the next phase starts here
+void profiler_end_phase(Profiler* p, ProfilePhase phase);
+
+// Record the whole tick; returns its duration
+uint64_t profiler_end_tick(Profiler* p);
+
+PhaseSummary profiler_phase_summary(const Profiler* p, ProfilePhase phase);
+PhaseSummary profiler_tick_summary(const Profiler* p);
+const char* profiler_phase_name(ProfilePhase phase);
+
+// True once (then cleared) after SIGUSR1 asked for a report
+bool profiler_report_requested(void);
+
+// Log p50/p99/max per phase and for the whole tick, then start a new window
+void profiler_report(Profiler* p);
+
+#endif
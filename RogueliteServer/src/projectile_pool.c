@@ -0,0 +1,131 @@
+#include "projectile_pool.h"
+#include "memory.h"
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Initialize pool (the only allocation it ever makes)
+void projectile_pool_init(ProjectilePool* pool, size_t capacity) {
+    if (capacity > HANDLE_MAX_SLOTS) capacity = HANDLE_MAX_SLOTS;
+
+    pool->pos_x = mem_alloc(capacity * sizeof(float));
+    pool->pos_y = mem_alloc(capacity * sizeof(float));
+    pool->vel_x = mem_alloc(capacity * sizeof(float));
+    pool->vel_y = mem_alloc(capacity * sizeof(float));
+    pool->rotation = mem_alloc(capacity * sizeof(float));
+    pool->id = mem_alloc(capacity * sizeof(uint32_t));
+    pool->owner_id = mem_alloc(capacity * sizeof(uint32_t));
+    pool->active = mem_alloc(capacity * sizeof(bool));
+
+    if (pool->pos_x == NULL || pool->pos_y == NULL || pool->vel_x == NULL ||
+        pool->vel_y == NULL || pool->rotation == NULL || pool->id == NULL ||
+        pool->owner_id == NULL || pool->active == NULL) {
+        fprintf(stderr, "Failed to allocate projectile pool!\n");
+        exit(1);
+    }
+
+    // Slot table sized up front: live handles never exceed capacity
+    handle_table_init(&pool->handles, capacity, HANDLE_TAG_BIT);
+
+    pool->count = 0;
+    pool->capacity = capacity;
+    pool->spawned = 0;
+    pool->dropped = 0;
+
+    LOG_INFO("ProjectilePool initialized with capacity %zu\n", capacity);
+}
+
+// Free pool
+void projectile_pool_free(ProjectilePool* pool) {
+    mem_free(pool->pos_x);
+    mem_free(pool->pos_y);
+    mem_free(pool->vel_x);
+    mem_free(pool->vel_y);
+    mem_free(pool->rotation);
+    mem_free(pool->id);
+    mem_free(pool->owner_id);
+    mem_free(pool->active);
+    handle_table_free(&pool->handles);
+    pool->count = 0;
+    pool->capacity = 0;
+}
+
+// Spawn projectile into the next dense slot
+uint32_t projectile_spawn(ProjectilePool* pool, Vector2 position, Vector2 velocity,
+                          uint32_t owner_id, float rotation) {
+    if (pool->count >= pool->capacity) {
+        pool->dropped++;
+        return HANDLE_INVALID;
+    }
+
+    size_t i = pool->count;
+    uint32_t id = handle_alloc(&pool->handles, (uint32_t)i);
+    if (id == HANDLE_INVALID) {
+        pool->dropped++;
+        return HANDLE_INVALID;
+    }
+    pool->count++;
+
+    pool->pos_x[i] = position.x;
+    pool->pos_y[i] = position.y;
+    pool->vel_x[i] = velocity.x;
+    pool->vel_y[i] = velocity.y;
+    pool->rotation[i] = rotation;
+    pool->id[i] = id;
+    pool->owner_id[i] = owner_id;
+    pool->active[i] = true;
+
+    pool->spawned++;
+    return id;
+}
+
+// pos[i] += vel[i] * dt over one axis
+static void integrate_axis(float* restrict pos, const float* restrict vel, size_t count, float delta_time) {
+    for (size_t i = 0; i < count; i++) {
+        pos[i] += vel[i] * delta_time;
+    }
+}
+
+// Move projectiles and cull the ones that left the map
+void projectile_pool_update(ProjectilePool* pool, float delta_time,
+                            float min_x, float min_y, float max_x, float max_y) {
+    integrate_axis(pool->pos_x, pool->vel_x, pool->count, delta_time);
+    integrate_axis(pool->pos_y, pool->vel_y, pool->count, delta_time);
+
+    const float* restrict pos_x = pool->pos_x;
+    const float* restrict pos_y = pool->pos_y;
+    bool* restrict active = pool->active;
+
+    for (size_t i = 0; i < pool->count; i++) {
+        bool outside = pos_x[i] < min_x || pos_x[i] > max_x ||
+                       pos_y[i] < min_y || pos_y[i] > max_y;
+        active[i] = active[i] && !outside;
+    }
+}
+
+// Swap-remove inactive projectiles and release their IDs
+void projectile_pool_compact(ProjectilePool* pool) {
+    for (size_t i = 0; i < pool->count; ) {
+        if (pool->active[i]) {
+            i++;
+            continue;
+        }
+
+        size_t last = pool->count - 1;
+        handle_release(&pool->handles, pool->id[i]);
+
+        if (i != last) {
+            pool->pos_x[i] = pool->pos_x[last];
+            pool->pos_y[i] = pool->pos_y[last];
+            pool->vel_x[i] = pool->vel_x[last];
+            pool->vel_y[i] = pool->vel_y[last];
+            pool->rotation[i] = pool->rotation[last];
+            pool->id[i] = pool->id[last];
+            pool->owner_id[i] = pool->owner_id[last];
+            pool->active[i] = pool->active[last];
+            handle_set_dense(&pool->handles, pool->id[i], (uint32_t)i);
+        }
+
+        pool->count--;
+    }
+}
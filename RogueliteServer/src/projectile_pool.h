@@ -0,0 +1,51 @@
+#ifndef PROJECTILE_POOL_H
+#define PROJECTILE_POOL_H
+
+#include "vector2.h"
+#include "handle_table.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Projectile box size (pixels)
+#define PROJECTILE_SIZE 8.0f
+
+// Fixed-capacity projectile pool (kept apart from players/enemies)
+// All arrays are allocated once at init and packed in [0, count), so the
+// integrate, cull and hit-test passes walk one homogeneous block of memory.
+// IDs come from a tagged handle table whose freed slots are recycled through
+// its free list, so they never collide with EntityManager IDs.
+typedef struct {
+    float* pos_x;
+    float* pos_y;
+    float* vel_x;
+    float* vel_y;
+    float* rotation;
+    uint32_t* id;
+    uint32_t* owner_id;    // Entity ID of the shooter
+    bool* active;          // Cleared on hit/cull; slot recycled at the sync point
+    
+    size_t count;
+    size_t capacity;
+    HandleTable handles;   // Projectile ID -> dense index
+    
+    uint64_t spawned;      // Lifetime counters
+    uint64_t dropped;      // Spawns refused because the pool was full
+} ProjectilePool;
+
+void projectile_pool_init(ProjectilePool* pool, size_t capacity);
+void projectile_pool_free(ProjectilePool* pool);
+
+// Spawn a projectile; returns its ID, or 0 if the pool is full.
+// Never allocates and never moves live projectiles.
+uint32_t projectile_spawn(ProjectilePool* pool, Vector2 position, Vector2 velocity,
+                          uint32_t owner_id, float rotation);
+
+// Integrate positions and deactivate projectiles that leave the given bounds
+void projectile_pool_update(ProjectilePool* pool, float delta_time,
+                            float min_x, float min_y, float max_x, float max_y);
+
+// Sync point: drop inactive projectiles and recycle their slots
+void projectile_pool_compact(ProjectilePool* pool);
+
+#endif
@@ -1,5 +1,6 @@
 #include "protocol.h"
 #include <string.h>
+#include <math.h>
 
 #ifdef _WIN32
     #include <winsock2.h>
@@ -20,6 +21,30 @@ static uint32_t read_uint32(const uint8_t* buffer) {
     return ntohl(net_value);
 }
 
+// Helper: Write uint64_t to buffer (network byte order, high word first)
+static void write_uint64(uint8_t* buffer, uint64_t value) {
+    write_uint32(buffer, (uint32_t)(value >> 32));
+    write_uint32(buffer + 4, (uint32_t)value);
+}
+
+// Helper: Read uint64_t from buffer
+static uint64_t read_uint64(const uint8_t* buffer) {
+    return ((uint64_t)read_uint32(buffer) << 32) | read_uint32(buffer + 4);
+}
+
+// Helper: Write uint16_t to buffer (network byte order)
+static void write_uint16(uint8_t* buffer, uint16_t value) {
+    uint16_t net_value = htons(value);
+    memcpy(buffer, &net_value, 2);
+}
+
+// Helper: Read uint16_t from buffer (network byte order)
+static uint16_t read_uint16(const uint8_t* buffer) {
+    uint16_t net_value;
+    memcpy(&net_value, buffer, 2);
+    return ntohs(net_value);
+}
+
 // Helper: Write float to buffer (as uint32_t, network byte order)
 static void write_float(uint8_t* buffer, float value) {
     uint32_t* value_as_int = (uint32_t*)&value;
@@ -132,156 +157,598 @@ int deserialize_input(const uint8_t* buffer, int buffer_size, InputMessage* msg)
     return offset;
 }
 
-// Serialize STATE message
-int serialize_state(const StateMessage* msg, uint8_t* buffer, int buffer_size) {
-    // Size: header(1+4+1) + entities(count*22) + wave(6) + names(1 + count*36)
-    int required = 6 + (msg->entity_count * 22) + 6 + (1 + msg->player_count * 36);
-    if (buffer_size < required) return -1;
+// Length of a player name as sent (at most 31 bytes)
+static uint8_t name_length(const char* name) {
+    uint8_t length = 0;
+    while (length < 31 && name[length] != '\0') length++;
+    return length;
+}
+
+// Begin a STATE packet (header plus an empty entity section)
+void state_writer_begin(StateWriter* w, uint8_t* buffer, int buffer_size,
+                        const StateMessage* header, uint32_t baseline_tick,
+                        uint8_t fragment_index) {
+    w->buffer = buffer;
+    w->capacity = buffer_size;
+    w->offset = 0;
+    
+    buffer[w->offset++] = MSG_STATE;
+    write_uint32(&buffer[w->offset], header->tick);
+    w->offset += 4;
+    write_uint32(&buffer[w->offset], baseline_tick);
+    w->offset += 4;
+    buffer[w->offset++] = fragment_index;  // Last-fragment bit patched by finish
+    buffer[w->offset++] = header->current_wave;
+    buffer[w->offset++] = header->wave_active;
+    write_float(&buffer[w->offset], header->wave_countdown);
+    w->offset += 4;
+    
+    // ID range, patched by finish
+    w->range_offset = w->offset;
+    w->offset += 8;
+    
+    // Entity record count, patched when the section closes
+    w->count_offset = w->offset;
+    w->offset += 2;
+    w->records = 0;
+    w->in_players = false;
+    w->bits = 0;
+    w->bit_count = 0;
+    w->last_id = 0;
+}
+
+#define TWO_PI 6.28318530718f
+
+// Quantizers shared by the encoder, the change test and the decoder
+static uint32_t quantize_position(float value, float min, float max) {
+    float limit = fminf((max - min) * STATE_POSITION_SCALE, (float)((1u << STATE_POSITION_BITS) - 1));
+    float q = rintf((value - min) * STATE_POSITION_SCALE);
+    if (!(q > 0.0f)) return 0;  // Also catches NaN
+    if (q > limit) q = limit;
+    return (uint32_t)q;
+}
+
+static float dequantize_position(uint32_t q, float min) {
+    return min + (float)q / STATE_POSITION_SCALE;
+}
+
+static uint32_t quantize_rotation(float rotation) {
+    float turns = rotation / TWO_PI;
+    turns -= floorf(turns);
+    return (uint32_t)lrintf(turns * (float)(1u << STATE_ROTATION_BITS)) & ((1u << STATE_ROTATION_BITS) - 1);
+}
+
+static float dequantize_rotation(uint32_t q) {
+    return (float)q * (TWO_PI / (float)(1u << STATE_ROTATION_BITS));
+}
+
+static uint32_t quantize_health(int16_t health, int16_t max_health) {
+    if (health <= 0) return 0;
+    if (max_health > 0 && health > max_health) return (uint32_t)max_health;
+    return (uint32_t)health;
+}
+
+// Bits for a health value given its max (enough to hold max_health)
+static int health_bits(int16_t max_health) {
+    int bits = 1;
+    while (bits < 16 && (1 << bits) <= max_health) bits++;
+    return bits;
+}
+
+// Which fields differ once quantized (all of them for a new entity; 0 = unchanged)
+int state_entity_flags(const EntityState* baseline, const EntityState* current) {
+    if (baseline == NULL) return DELTA_ALL_FIELDS;
+    
+    int flags = 0;
+    if (quantize_position(current->x, MAP_MIN_X, MAP_MAX_X) != quantize_position(baseline->x, MAP_MIN_X, MAP_MAX_X) ||
+        quantize_position(current->y, MAP_MIN_Y, MAP_MAX_Y) != quantize_position(baseline->y, MAP_MIN_Y, MAP_MAX_Y)) {
+        flags |= DELTA_POSITION;
+    }
+    if (quantize_health(current->health, current->max_health) !=
+        quantize_health(baseline->health, baseline->max_health)) flags |= DELTA_HEALTH;
+    if (current->max_health != baseline->max_health) flags |= DELTA_MAX_HEALTH;
+    if (quantize_rotation(current->rotation) != quantize_rotation(baseline->rotation)) flags |= DELTA_ROTATION;
+    return flags;
+}
+
+// Width of an id gap: 2-bit class + 4/8/16/32 bits
+static int id_gap_class(uint32_t gap) {
+    if (gap < (1u << 4)) return 0;
+    if (gap < (1u << 8)) return 1;
+    if (gap < (1u << 16)) return 2;
+    return 3;
+}
+
+static const int ID_GAP_BITS[4] = {4, 8, 16, 32};
+
+// Bits an entity record takes
+static int entity_record_bits(int flags, uint32_t gap, int16_t max_health) {
+    int bits = 2 + ID_GAP_BITS[id_gap_class(gap)] + DELTA_FLAG_BITS;
+    if (flags & DELTA_TYPE) bits += STATE_TYPE_BITS;
+    if (flags & DELTA_POSITION) bits += 2 * STATE_POSITION_BITS;
+    if (flags & DELTA_MAX_HEALTH) bits += 16;
+    if (flags & DELTA_HEALTH) bits += health_bits(max_health);
+    if (flags & DELTA_ROTATION) bits += STATE_ROTATION_BITS;
+    return bits;
+}
+
+int state_record_bits(int flags, int16_t max_health) {
+    return entity_record_bits(flags, 0, max_health);
+}
+
+// Room for 'bits' more entity bits, keeping 2 bytes for the player count
+static bool writer_fits_bits(const StateWriter* w, int bits) {
+    return w->offset * 8 + w->bit_count + bits + 16 <= w->capacity * 8;
+}
+
+// Append the low 'count' bits of value (count <= 32); whole bytes go straight out
+static void write_bits(StateWriter* w, uint32_t value, int count) {
+    if (count < 32) value &= (1u << count) - 1;
+    w->bits = (w->bits << count) | value;
+    w->bit_count += count;
+    while (w->bit_count >= 8) {
+        w->bit_count -= 8;
+        w->buffer[w->offset++] = (uint8_t)(w->bits >> w->bit_count);
+    }
+}
+
+// Record start: id gap + flags
+static void write_record_header(StateWriter* w, uint32_t id, int flags) {
+    uint32_t gap = (w->records == 0) ? id : id - w->last_id - 1;
+    int gap_class = id_gap_class(gap);
+    write_bits(w, (uint32_t)gap_class, 2);
+    write_bits(w, gap, ID_GAP_BITS[gap_class]);
+    write_bits(w, (uint32_t)flags, DELTA_FLAG_BITS);
+    w->last_id = id;
+}
+
+// Gap the next record would use
+static uint32_t writer_gap(const StateWriter* w, uint32_t id) {
+    return (w->records == 0) ? id : id - w->last_id - 1;
+}
+
+// Write the changed fields of one entity (no-op if nothing changed)
+bool state_writer_entity(StateWriter* w, const EntityState* baseline, const EntityState* current) {
+    int flags = state_entity_flags(baseline, current);
+    if (flags == 0) return true;
     
-    int offset = 0;
+    uint32_t gap = writer_gap(w, current->entity_id);
+    if (!writer_fits_bits(w, entity_record_bits(flags, gap, current->max_health))) return false;
     
-    // Message type
-    buffer[offset++] = MSG_STATE;
+    write_record_header(w, current->entity_id, flags);
+    if (flags & DELTA_TYPE) {
+        write_bits(w, current->entity_type, STATE_TYPE_BITS);
+    }
+    if (flags & DELTA_POSITION) {
+        write_bits(w, quantize_position(current->x, MAP_MIN_X, MAP_MAX_X), STATE_POSITION_BITS);
+        write_bits(w, quantize_position(current->y, MAP_MIN_Y, MAP_MAX_Y), STATE_POSITION_BITS);
+    }
+    if (flags & DELTA_MAX_HEALTH) {
+        write_bits(w, (uint16_t)current->max_health, 16);
+    }
+    if (flags & DELTA_HEALTH) {
+        write_bits(w, quantize_health(current->health, current->max_health), health_bits(current->max_health));
+    }
+    if (flags & DELTA_ROTATION) {
+        write_bits(w, quantize_rotation(current->rotation), STATE_ROTATION_BITS);
+    }
     
-    // Tick number (4 bytes)
-    write_uint32(&buffer[offset], msg->tick);
-    offset += 4;
+    w->records++;
+    return true;
+}
+
+// Tell the client an entity is gone
+bool state_writer_remove(StateWriter* w, uint32_t entity_id) {
+    if (!writer_fits_bits(w, entity_record_bits(DELTA_REMOVED, writer_gap(w, entity_id), 0))) return false;
     
-    // Entity count (1 byte)
-    buffer[offset++] = msg->entity_count;
+    write_record_header(w, entity_id, DELTA_REMOVED);
+    w->records++;
+    return true;
+}
+
+// Player record: id(4) + name length(1) + name bytes (at most 31)
+int state_player_size(const PlayerInfo* player) {
+    return 4 + 1 + name_length(player->name);
+}
+
+// Close the entity section (pad to a byte) and open the player section
+static void writer_start_players(StateWriter* w) {
+    if (w->bit_count > 0) {
+        w->buffer[w->offset++] = (uint8_t)(w->bits << (8 - w->bit_count));
+        w->bit_count = 0;
+    }
+    write_int16(&w->buffer[w->count_offset], (int16_t)w->records);
+    w->count_offset = w->offset;
+    w->offset += 2;
+    w->records = 0;
+    w->in_players = true;
+}
+
+// Write one player name (after all entity records)
+bool state_writer_player(StateWriter* w, const PlayerInfo* player) {
+    if (!w->in_players) writer_start_players(w);
+    if (w->offset + state_player_size(player) > w->capacity) return false;
     
+    write_uint32(&w->buffer[w->offset], player->player_id);
+    w->offset += 4;
     
-    // Each entity
-    for (int i = 0; i < msg->entity_count; i++) {
-        const EntityState* e = &msg->entities[i];
-        
-        // Entity ID (4 bytes)
-        write_uint32(&buffer[offset], e->entity_id);
-        offset += 4;
-        
-        // Entity type (1 byte)
-        buffer[offset++] = e->entity_type;
-        
-        // Position (8 bytes)
-        write_float(&buffer[offset], e->x);
-        offset += 4;
-        write_float(&buffer[offset], e->y);
-        offset += 4;
-        
-        // Health (2 bytes)
-        write_int16(&buffer[offset], e->health);
-        offset += 2;
-        
-        // Max Health (2 bytes)
-        write_int16(&buffer[offset], e->max_health);
-        offset += 2;
-        
-        // NEW: Rotation (4 bytes)
-        write_float(&buffer[offset], e->rotation);
-        offset += 4;
+    uint8_t length = name_length(player->name);
+    w->buffer[w->offset++] = length;
+    memcpy(&w->buffer[w->offset], player->name, length);
+    w->offset += length;
+    
+    w->records++;
+    return true;
+}
+
+// Patch record counts and the ID range; returns the packet size
+int state_writer_finish(StateWriter* w, uint32_t range_start, uint32_t range_last,
+                        bool last_fragment) {
+    if (!w->in_players) writer_start_players(w);
+    write_int16(&w->buffer[w->count_offset], (int16_t)w->records);
+    write_uint32(&w->buffer[w->range_offset], range_start);
+    write_uint32(&w->buffer[w->range_offset + 4], range_last);
+    if (last_fragment) w->buffer[9] |= STATE_LAST_FRAGMENT;
+    return w->offset;
+}
+
+// Serialize STATE message as a delta (merge of two id-sorted entity lists)
+int serialize_state(const StateMessage* baseline, const StateMessage* current,
+                    uint8_t* buffer, int buffer_size) {
+    if (buffer_size < STATE_HEADER_SIZE + 4) return -1;
+    
+    StateWriter w;
+    state_writer_begin(&w, buffer, buffer_size, current, baseline ? baseline->tick : 0, 0);
+    
+    int b = 0, c = 0;
+    int base_count = baseline ? baseline->entity_count : 0;
+    while (b < base_count || c < current->entity_count) {
+        const EntityState* base = (b < base_count) ? &baseline->entities[b] : NULL;
+        const EntityState* cur = (c < current->entity_count) ? &current->entities[c] : NULL;
+        bool ok;
         
-        // Active (1 byte)
-        buffer[offset++] = e->active ? 1 : 0;
+        if (cur == NULL || (base != NULL && base->entity_id < cur->entity_id)) {
+            ok = state_writer_remove(&w, base->entity_id);      // Gone
+            b++;
+        } else if (base == NULL || cur->entity_id < base->entity_id) {
+            ok = state_writer_entity(&w, NULL, cur);            // New
+            c++;
+        } else {
+            ok = state_writer_entity(&w, base, cur);            // Changed (or not)
+            b++;
+            c++;
+        }
+        if (!ok) return -1;
     }
     
-    // Wave system data
-    buffer[offset++] = msg->current_wave;     // 1 byte
-    buffer[offset++] = msg->wave_active;      // 1 byte
-    write_float(&buffer[offset], msg->wave_countdown);  // 4 bytes
-    offset += 4;
-    
-    // NEW: Player names
-    buffer[offset++] = msg->player_count;  // 1 byte
-    for (int i = 0; i < msg->player_count && i < 4; i++) {
-        // Player ID (4 bytes)
-        write_uint32(&buffer[offset], msg->players[i].player_id);
-        offset += 4;
-        
-        // Name (32 bytes)
-        memcpy(&buffer[offset], msg->players[i].name, 32);
-        offset += 32;
+    for (int i = 0; i < current->player_count; i++) {
+        if (!state_writer_player(&w, &current->players[i])) return -1;
     }
     
-    return offset;
+    return state_writer_finish(&w, STATE_RANGE_ALL_START, STATE_RANGE_ALL_LAST, true);
+}
+
+// Bit-level reader over a received packet (MSB first)
+typedef struct {
+    const uint8_t* buffer;
+    int position;       // In bits
+    int end;            // In bits
+    bool overrun;       // Read past the end (results are zeros)
+} BitReader;
+
+static uint32_t read_bits(BitReader* r, int count) {
+    if (r->position + count > r->end) {
+        r->overrun = true;
+        return 0;
+    }
+    uint32_t value = 0;
+    while (count > 0) {
+        int used = r->position & 7;
+        int take = 8 - used;
+        if (take > count) take = count;
+        uint32_t byte = r->buffer[r->position >> 3];
+        value = (value << take) | ((byte >> (8 - used - take)) & ((1u << take) - 1));
+        r->position += take;
+        count -= take;
+    }
+    return value;
+}
+
+// Peek at the baseline tick of a STATE packet
+uint32_t state_baseline_tick(const uint8_t* buffer, int buffer_size) {
+    if (buffer_size < STATE_HEADER_SIZE) return 0;
+    return read_uint32(&buffer[5]);
+}
+
+bool state_peek_fragment(const uint8_t* buffer, int buffer_size, uint32_t* tick,
+                         uint8_t* fragment_index, bool* last_fragment) {
+    if (buffer_size < STATE_HEADER_SIZE) return false;
+    *tick = read_uint32(&buffer[1]);
+    *fragment_index = buffer[9] & ~STATE_LAST_FRAGMENT;
+    *last_fragment = (buffer[9] & STATE_LAST_FRAGMENT) != 0;
+    return true;
 }
 
-// Deserialize STATE message
-// Deserialize STATE message
-int deserialize_state(const uint8_t* buffer, int length, StateMessage* msg) {
-    if (length < 6) return -1;  // Minimum size (CHANGED: return -1)
+// Append an entity to out (false if out is full)
+static bool state_push(StateMessage* out, const EntityState* e) {
+    if (out->entity_count >= out->entity_capacity) return false;
+    out->entities[out->entity_count++] = *e;
+    return true;
+}
+
+// Deserialize STATE message: baseline + records -> full state
+int deserialize_state(const uint8_t* buffer, int length,
+                      const StateMessage* baseline, StateMessage* out) {
+    if (length < STATE_HEADER_SIZE + 2) return -1;
     
     int offset = 1;  // Skip message type
     
-    // Tick
-    msg->tick = read_uint32(&buffer[offset]);
+    out->tick = read_uint32(&buffer[offset]);
     offset += 4;
     
-    // Entity count
-    msg->entity_count = buffer[offset++];
+    uint32_t baseline_tick = read_uint32(&buffer[offset]);
+    offset += 4;
+    if (baseline_tick != 0 && (baseline == NULL || baseline->tick != baseline_tick)) {
+        return -1;  // We don't have the state this was encoded against
+    }
+    if (baseline_tick == 0) baseline = NULL;
     
-    // Each entity
-    for (int i = 0; i < msg->entity_count && i < 32; i++) {
-        if (offset + 25 > length) break;  // Safety check: 4+1+4+4+2+2+4+1 = 22 bytes + buffer
-        
-        EntityState* e = &msg->entities[i];
-        
-        // Entity ID
-        e->entity_id = read_uint32(&buffer[offset]);
-        offset += 4;
+    uint8_t fragment = buffer[offset++];
+    out->fragment_index = fragment & ~STATE_LAST_FRAGMENT;
+    out->last_fragment = (fragment & STATE_LAST_FRAGMENT) != 0;
+    
+    // Wave system data
+    out->current_wave = buffer[offset++];
+    out->wave_active = buffer[offset++];
+    out->wave_countdown = read_float(&buffer[offset]);
+    offset += 4;
+    
+    out->range_start = read_uint32(&buffer[offset]);
+    out->range_last = read_uint32(&buffer[offset + 4]);
+    offset += 8;
+    uint32_t range_start = out->range_start;
+    uint32_t range_last = out->range_last;
+    
+    // Entity records merged with the baseline (both in id order)
+    int record_count = (uint16_t)read_int16(&buffer[offset]);
+    offset += 2;
+    
+    // Only the baseline entities inside this fragment's range
+    out->entity_count = 0;
+    int b = 0;
+    int base_count = 0;
+    if (baseline != NULL && range_start <= range_last) {
+        while (b < baseline->entity_count && baseline->entities[b].entity_id < range_start) b++;
+        base_count = b;
+        while (base_count < baseline->entity_count &&
+               baseline->entities[base_count].entity_id <= range_last) base_count++;
+    }
+    
+    BitReader reader = {buffer, offset * 8, length * 8, false};
+    uint32_t id = 0;
+    
+    for (int r = 0; r < record_count; r++) {
+        int gap_class = (int)read_bits(&reader, 2);
+        uint32_t gap = read_bits(&reader, ID_GAP_BITS[gap_class]);
+        id = (r == 0) ? gap : id + 1 + gap;
+        int flags = (int)read_bits(&reader, DELTA_FLAG_BITS);
+        if (reader.overrun) return -1;
+        if (id < range_start || id > range_last) return -1;
         
-        // Entity type
-        e->entity_type = buffer[offset++];
+        // Baseline entities before this id are unchanged
+        while (b < base_count && baseline->entities[b].entity_id < id) {
+            if (!state_push(out, &baseline->entities[b++])) return -1;
+        }
         
-        // Position
-        e->x = read_float(&buffer[offset]);
-        offset += 4;
-        e->y = read_float(&buffer[offset]);
-        offset += 4;
+        EntityState e;
+        bool in_baseline = b < base_count && baseline->entities[b].entity_id == id;
+        if (in_baseline) {
+            e = baseline->entities[b++];
+        } else {
+            if (!(flags & DELTA_TYPE) && !(flags & DELTA_REMOVED)) return -1;  // Unknown entity
+            memset(&e, 0, sizeof(e));
+            e.entity_id = id;
+            e.active = true;
+        }
         
-        // Health
-        e->health = read_int16(&buffer[offset]);
-        offset += 2;
+        if (flags & DELTA_REMOVED) continue;
         
-        // Max Health
-        e->max_health = read_int16(&buffer[offset]);
-        offset += 2;
+        if (flags & DELTA_TYPE) {
+            e.entity_type = (uint8_t)read_bits(&reader, STATE_TYPE_BITS);
+        }
+        if (flags & DELTA_POSITION) {
+            e.x = dequantize_position(read_bits(&reader, STATE_POSITION_BITS), MAP_MIN_X);
+            e.y = dequantize_position(read_bits(&reader, STATE_POSITION_BITS), MAP_MIN_Y);
+        }
+        if (flags & DELTA_MAX_HEALTH) {
+            e.max_health = (int16_t)read_bits(&reader, 16);
+        }
+        if (flags & DELTA_HEALTH) {
+            e.health = (int16_t)read_bits(&reader, health_bits(e.max_health));
+        }
+        if (flags & DELTA_ROTATION) {
+            e.rotation = dequantize_rotation(read_bits(&reader, STATE_ROTATION_BITS));
+        }
         
-        // NEW: Rotation
-        e->rotation = read_float(&buffer[offset]);
+        if (reader.overrun) return -1;
+        if (!state_push(out, &e)) return -1;
+    }
+    offset = (reader.position + 7) / 8;  // Entity section is padded to a byte
+    
+    // Rest of the baseline is unchanged
+    while (b < base_count) {
+        if (!state_push(out, &baseline->entities[b++])) return -1;
+    }
+    
+    // Player names in this packet
+    out->player_count = 0;
+    if (offset + 2 > length) return -1;
+    int player_records = (uint16_t)read_int16(&buffer[offset]);
+    offset += 2;
+    
+    for (int i = 0; i < player_records; i++) {
+        if (offset + 5 > length) return -1;
+        uint32_t player_id = read_uint32(&buffer[offset]);
         offset += 4;
         
-        // Active
-        e->active = buffer[offset++] != 0;
+        uint8_t size = buffer[offset++];
+        if (size > 31 || offset + size > length) return -1;
+        
+        if (out->players != NULL && out->player_count < out->player_capacity) {
+            PlayerInfo* player = &out->players[out->player_count++];
+            player->player_id = player_id;
+            memcpy(player->name, &buffer[offset], size);
+            player->name[size] = '\0';
+        }
+        offset += size;
     }
     
-    // Wave system data (if available)
-    if (offset + 6 <= length) {
-        msg->current_wave = buffer[offset++];
-        msg->wave_active = buffer[offset++];
-        msg->wave_countdown = read_float(&buffer[offset]);
-        offset += 4;
-    } else {
-        msg->current_wave = 0;
-        msg->wave_active = 0;
-        msg->wave_countdown = 0.0f;
+    return offset;
+}
+
+// Index of the first entity with id >= 'id'
+static int state_lower_bound(const StateMessage* state, uint32_t id) {
+    int lo = 0, hi = state->entity_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (state->entities[mid].entity_id < id) lo = mid + 1;
+        else hi = mid;
     }
+    return lo;
+}
+
+// Splice a decoded fragment's range into target
+bool state_apply_fragment(StateMessage* target, const StateMessage* fragment) {
+    if (fragment->range_start > fragment->range_last) return true;  // Players only
+    
+    int lo = state_lower_bound(target, fragment->range_start);
+    int hi = lo;
+    while (hi < target->entity_count && target->entities[hi].entity_id <= fragment->range_last) hi++;
+    
+    int tail = target->entity_count - hi;
+    int new_count = lo + fragment->entity_count + tail;
+    if (new_count > target->entity_capacity) return false;
+    
+    memmove(&target->entities[lo + fragment->entity_count], &target->entities[hi],
+            (size_t)tail * sizeof(EntityState));
+    memcpy(&target->entities[lo], fragment->entities,
+           (size_t)fragment->entity_count * sizeof(EntityState));
+    target->entity_count = (uint16_t)new_count;
+    return true;
+}
+
+// Serialize ACK message
+int serialize_ack(uint32_t tick, uint8_t* buffer, int buffer_size) {
+    if (buffer_size < 5) return -1;
+    buffer[0] = MSG_ACK;
+    write_uint32(&buffer[1], tick);
+    return 5;
+}
+
+// Deserialize ACK message
+int deserialize_ack(const uint8_t* buffer, int buffer_size, uint32_t* tick) {
+    if (buffer_size < 5) return -1;
+    *tick = read_uint32(&buffer[1]);
+    return 5;
+}
+
+// Serialize STATS_REQUEST message
+int serialize_stats_request(uint16_t first_client, uint8_t* buffer, int buffer_size) {
+    if (buffer_size < 3) return -1;
+    buffer[0] = MSG_STATS_REQUEST;
+    write_uint16(&buffer[1], first_client);
+    return 3;
+}
+
+// Deserialize STATS_REQUEST message
+int deserialize_stats_request(const uint8_t* buffer, int buffer_size, uint16_t* first_client) {
+    if (buffer_size < 3) return -1;
+    *first_client = read_uint16(&buffer[1]);
+    return 3;
+}
+
+// Serialize STATS message
+int serialize_stats(const StatsMessage* msg, uint8_t* buffer, int buffer_size) {
+    int records = msg->client_records;
+    if (records > STATS_MAX_CLIENTS) return -1;
+    int size = STATS_HEADER_SIZE + records * STATS_CLIENT_SIZE;
+    if (buffer_size < size) return -1;
     
-    // NEW: Player names (if available)
-    if (offset + 1 <= length) {
-        msg->player_count = buffer[offset++];
-        for (int i = 0; i < msg->player_count && i < 4 && offset + 36 <= length; i++) {
-            // Player ID
-            msg->players[i].player_id = read_uint32(&buffer[offset]);
-            offset += 4;
-            
-            // Name
-            memcpy(msg->players[i].name, &buffer[offset], 32);
-            msg->players[i].name[31] = '\0';  // Ensure null-terminated
-            offset += 32;
-        }
-    } else {
-        msg->player_count = 0;
+    int offset = 0;
+    buffer[offset++] = MSG_STATS;
+    write_uint32(&buffer[offset], msg->tick); offset += 4;
+    buffer[offset++] = msg->current_wave;
+    write_uint16(&buffer[offset], msg->client_count); offset += 2;
+    write_uint32(&buffer[offset], msg->profile_ticks); offset += 4;
+    write_uint32(&buffer[offset], msg->tick_p50_us); offset += 4;
+    write_uint32(&buffer[offset], msg->tick_p99_us); offset += 4;
+    write_uint32(&buffer[offset], msg->tick_max_us); offset += 4;
+    write_uint32(&buffer[offset], msg->tick_overruns); offset += 4;
+    for (int i = 0; i < 3; i++) {
+        write_uint32(&buffer[offset], msg->entity_counts[i]); offset += 4;
+    }
+    write_uint32(&buffer[offset], msg->inputs_dropped); offset += 4;
+    write_uint32(&buffer[offset], msg->projectiles_dropped); offset += 4;
+    write_uint32(&buffer[offset], msg->log_dropped); offset += 4;
+    write_uint64(&buffer[offset], msg->heap_allocs); offset += 8;
+    write_uint64(&buffer[offset], msg->heap_frees); offset += 8;
+    write_uint64(&buffer[offset], msg->heap_bytes); offset += 8;
+    write_uint32(&buffer[offset], msg->tick_allocs); offset += 4;
+    write_uint16(&buffer[offset], msg->next_client); offset += 2;
+    buffer[offset++] = (uint8_t)records;
+    
+    for (int i = 0; i < records; i++) {
+        const ClientStats* c = &msg->clients[i];
+        write_uint32(&buffer[offset], c->player_id); offset += 4;
+        write_uint32(&buffer[offset], c->rtt_us); offset += 4;
+        write_uint64(&buffer[offset], c->bytes_sent); offset += 8;
+        write_uint64(&buffer[offset], c->bytes_received); offset += 8;
+        write_uint32(&buffer[offset], c->packets_sent); offset += 4;
+        write_uint32(&buffer[offset], c->packets_received); offset += 4;
     }
     
     return offset;
-}
\ No newline at end of file
+}
+
+// Deserialize STATS message
+int deserialize_stats(const uint8_t* buffer, int buffer_size, StatsMessage* msg) {
+    if (buffer_size < STATS_HEADER_SIZE) return -1;
+    
+    int offset = 1;
+    msg->tick = read_uint32(&buffer[offset]); offset += 4;
+    msg->current_wave = buffer[offset++];
+    msg->client_count = read_uint16(&buffer[offset]); offset += 2;
+    msg->profile_ticks = read_uint32(&buffer[offset]); offset += 4;
+    msg->tick_p50_us = read_uint32(&buffer[offset]); offset += 4;
+    msg->tick_p99_us = read_uint32(&buffer[offset]); offset += 4;
+    msg->tick_max_us = read_uint32(&buffer[offset]); offset += 4;
+    msg->tick_overruns = read_uint32(&buffer[offset]); offset += 4;
+    for (int i = 0; i < 3; i++) {
+        msg->entity_counts[i] = read_uint32(&buffer[offset]); offset += 4;
+    }
+    msg->inputs_dropped = read_uint32(&buffer[offset]); offset += 4;
+    msg->projectiles_dropped = read_uint32(&buffer[offset]); offset += 4;
+    msg->log_dropped = read_uint32(&buffer[offset]); offset += 4;
+    msg->heap_allocs = read_uint64(&buffer[offset]); offset += 8;
+    msg->heap_frees = read_uint64(&buffer[offset]); offset += 8;
+    msg->heap_bytes = read_uint64(&buffer[offset]); offset += 8;
+    msg->tick_allocs = read_uint32(&buffer[offset]); offset += 4;
+    msg->next_client = read_uint16(&buffer[offset]); offset += 2;
+    int records = buffer[offset++];
+    
+    if (records > msg->client_capacity) return -1;
+    if (buffer_size < offset + records * STATS_CLIENT_SIZE) return -1;
+    msg->client_records = (uint8_t)records;
+    
+    for (int i = 0; i < records; i++) {
+        ClientStats* c = &msg->clients[i];
+        c->player_id = read_uint32(&buffer[offset]); offset += 4;
+        c->rtt_us = read_uint32(&buffer[offset]); offset += 4;
+        c->bytes_sent = read_uint64(&buffer[offset]); offset += 8;
+        c->bytes_received = read_uint64(&buffer[offset]); offset += 8;
+        c->packets_sent = read_uint32(&buffer[offset]); offset += 4;
+        c->packets_received = read_uint32(&buffer[offset]); offset += 4;
+    }
+    
+    return offset;
+}
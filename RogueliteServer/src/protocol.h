@@ -12,7 +12,10 @@ typedef enum {
     MSG_STATE = 3,        // Server → Client: Game state
     MSG_PING = 4,         // Bidirectional: Keep-alive
     MSG_PONG = 5,         // Response to ping
-    MSG_WELCOME = 6       // NEW: Server → Client: Your player ID
+    MSG_WELCOME = 6,      // NEW: Server → Client: Your player ID
+    MSG_ACK = 7,          // Client → Server: Last STATE tick received
+    MSG_STATS_REQUEST = 8, // Admin → Server (localhost only): Metrics snapshot please
+    MSG_STATS = 9         // Server → Admin: Metrics snapshot
 } MessageType;
 
 // Input keys (bitflags)
@@ -22,8 +25,22 @@ typedef enum {
 #define KEY_D     0x08  // 0000 1000
 #define KEY_SPACE 0x10  // 0001 0000
 
-// Maximum packet size
-#define MAX_PACKET_SIZE 1024
+// Map boundaries (match client grid; STATE positions are quantized to them)
+#define MAP_MIN_X -400.0f
+#define MAP_MIN_Y -300.0f
+#define MAP_MAX_X 1200.0f
+#define MAP_MAX_Y 900.0f
+
+// Dungeon tile grid laid over the map from (MAP_MIN_X, MAP_MIN_Y), 32px tiles
+#define DUNGEON_WIDTH 50
+#define DUNGEON_HEIGHT 37
+
+// WELCOME: type(1) player_id(4) dungeon_seed(4), big-endian. The client
+// regenerates the dungeon from the seed; tiles are never sent.
+#define WELCOME_SIZE 9
+
+// Maximum packet size (fits the 1280-byte IPv6 minimum MTU with IP/UDP headers)
+#define MAX_PACKET_SIZE 1200
 
 // Connect message (client → server)
 typedef struct {
@@ -49,25 +66,96 @@ typedef struct {
     bool active;
 } EntityState;
 
-// State message (server → client)
+// Player name entry (STATE player list)
+typedef struct {
+    uint32_t player_id;   // Player entity ID
+    char name[32];        // Player name (sent length-prefixed, without padding)
+} PlayerInfo;
+
+// Game state at one tick (server → client, sent as a delta).
+// Entities and players live in caller-owned storage; entities are sorted
+// by entity_id so two states can be diffed with a single merge pass.
+// A decoded fragment holds only the entities in [range_start, range_last].
 typedef struct {
-    uint32_t tick;         // Server tick number
-    uint8_t entity_count;  // How many entities
-    EntityState entities[32];  // Max 32 entities
+    uint32_t tick;         // Server tick number (the snapshot sequence number)
+    
+    // Fragmentation: a tick's state is split over several packets by entity ID
+    uint8_t fragment_index;
+    bool last_fragment;
+    uint32_t range_start;
+    uint32_t range_last;   // Inclusive; range_start > range_last = no entities
     
     // Wave system
     uint8_t current_wave;
     uint8_t wave_active;      // 1 = active, 0 = countdown
     float wave_countdown;     // Seconds until next wave
     
-    // NEW: Player names (for displaying above characters)
-    uint8_t player_count;     // Number of connected players
-    struct {
-        uint32_t player_id;   // Player entity ID
-        char name[32];        // Player name
-    } players[4];             // Max 4 players
+    uint16_t entity_count;
+    uint16_t entity_capacity;
+    EntityState* entities;
+    
+    // Player names (for displaying above characters). Names are sent until
+    // acknowledged, so a decoded state only holds the ones in that packet.
+    uint16_t player_count;
+    uint16_t player_capacity;
+    PlayerInfo* players;
 } StateMessage;
 
+// STATE wire format (one fragment):
+//   type(1) tick(4) baseline_tick(4) fragment(1) wave(1) wave_active(1) countdown(4)
+//   range_start(4) range_last(4)
+//   entity_records(2) { bit-packed records, padded to a whole byte }
+//   player_records(2) { id(4) name_length(1) name }
+// baseline_tick 0 means "no baseline": every entity is sent as new.
+// fragment is the index within the tick, with STATE_LAST_FRAGMENT set on
+// the final one. Fragments cover disjoint ID ranges, so each decodes on its
+// own against the baseline and a lost one only loses its range. Records are
+// sorted by id; entities in range missing from the records are unchanged.
+#define STATE_HEADER_SIZE 24   // Everything before entity_records
+#define STATE_LAST_FRAGMENT 0x80
+#define STATE_MAX_FRAGMENTS 32 // Per tick per client (a client can track them in a 32-bit mask)
+#define STATE_RANGE_ALL_START 0u
+#define STATE_RANGE_ALL_LAST  0xFFFFFFFFu
+
+// Entity record (bits, MSB first; fields in this order when flagged):
+//   id gap:     class(2) selects 4/8/16/32 bits; gap from the previous
+//               record's id minus one (the first record sends its id)
+//   flags:      6 bits (DELTA_*)
+//   type:       2 bits
+//   position:   x, y in STATE_POSITION_BITS each, 1/STATE_POSITION_SCALE px
+//               steps from MAP_MIN_X / MAP_MIN_Y
+//   max_health: 16 bits
+//   health:     clamped to 0..max_health, in just enough bits for max_health
+//   rotation:   STATE_ROTATION_BITS over [0, 2*pi)
+// Every entity in a STATE is active, so 'active' isn't sent.
+#define DELTA_REMOVED    0x01   // Entity left the state (no fields follow)
+#define DELTA_TYPE       0x02   // Only on entities new to the client
+#define DELTA_POSITION   0x04
+#define DELTA_HEALTH     0x08
+#define DELTA_MAX_HEALTH 0x10
+#define DELTA_ROTATION   0x20
+#define DELTA_ALL_FIELDS (DELTA_TYPE | DELTA_POSITION | DELTA_HEALTH | DELTA_MAX_HEALTH | DELTA_ROTATION)
+#define DELTA_FLAG_BITS  6
+
+#define STATE_TYPE_BITS 2
+#define STATE_POSITION_SCALE 8.0f   // 1/8 px
+#define STATE_POSITION_BITS 14      // (MAP_MAX - MAP_MIN) * scale must fit: 12800 and 9600
+#define STATE_ROTATION_BITS 9       // ~0.7 degree steps
+
+// Incremental STATE encoder: writes records straight into a packet buffer
+typedef struct {
+    uint8_t* buffer;
+    int capacity;
+    int offset;
+    int count_offset;       // Where the current section's record count goes
+    int range_offset;       // Where range_start/range_last go
+    uint16_t records;       // Records in the current section
+    bool in_players;        // Entity section closed, writing players
+    uint64_t bits;          // Pending entity bits not yet written out (low bit_count)
+    int bit_count;
+    uint32_t last_id;       // Previous record's id (for the id gap)
+} StateWriter;
+
 // Serialization functions
 int serialize_connect(const ConnectMessage* msg, uint8_t* buffer, int buffer_size);
 int deserialize_connect(const uint8_t* buffer, int buffer_size, ConnectMessage* msg);
@@ -75,7 +163,107 @@ int deserialize_connect(const uint8_t* buffer, int buffer_size, ConnectMessage*
 int serialize_input(const InputMessage* msg, uint8_t* buffer, int buffer_size);
 int deserialize_input(const uint8_t* buffer, int buffer_size, InputMessage* msg);
 
-int serialize_state(const StateMessage* msg, uint8_t* buffer, int buffer_size);
-int deserialize_state(const uint8_t* buffer, int buffer_size, StateMessage* msg);
+// STATE encoding as a single fragment covering every ID. baseline may be
+// NULL (full state); players are always sent. -1 if it doesn't fit.
+int serialize_state(const StateMessage* baseline, const StateMessage* current,
+                    uint8_t* buffer, int buffer_size);
+
+// Fragment encoder: begin, write records in id order (false = fragment full),
+// then finish with the ID range the fragment turned out to cover.
+void state_writer_begin(StateWriter* w, uint8_t* buffer, int buffer_size,
+                        const StateMessage* header, uint32_t baseline_tick,
+                        uint8_t fragment_index);
+// Which fields differ once quantized (all of them for a new entity; 0 = unchanged)
+int state_entity_flags(const EntityState* baseline, const EntityState* current);
+
+// Bits an entity record with these flags takes, assuming a short id gap
+int state_record_bits(int flags, int16_t max_health);
+bool state_writer_entity(StateWriter* w, const EntityState* baseline, const EntityState* current);
+bool state_writer_remove(StateWriter* w, uint32_t entity_id);
+bool state_writer_player(StateWriter* w, const PlayerInfo* player);
+int state_writer_finish(StateWriter* w, uint32_t range_start, uint32_t range_last,
+                        bool last_fragment);
+
+// Bytes one player entry takes in a STATE message
+int state_player_size(const PlayerInfo* player);
+
+// STATE decoding of one fragment into msg's storage. Returns -1 if the
+// packet's baseline isn't the one given (or storage runs out).
+uint32_t state_baseline_tick(const uint8_t* buffer, int buffer_size);
+// Tick and fragment index/last flag of a STATE packet without decoding it
+bool state_peek_fragment(const uint8_t* buffer, int buffer_size, uint32_t* tick,
+                         uint8_t* fragment_index, bool* last_fragment);
+int deserialize_state(const uint8_t* buffer, int buffer_size,
+                      const StateMessage* baseline, StateMessage* msg);
+
+// Replace target's entities in the fragment's range with the fragment's.
+// Applying every fragment of a tick to an empty state rebuilds the full state.
+bool state_apply_fragment(StateMessage* target, const StateMessage* fragment);
+
+int serialize_ack(uint32_t tick, uint8_t* buffer, int buffer_size);
+int deserialize_ack(const uint8_t* buffer, int buffer_size, uint32_t* tick);
+
+// One client's traffic counters (since it connected)
+typedef struct {
+    uint32_t player_id;
+    uint32_t rtt_us;          // Smoothed STATE-to-ACK round trip (0 = no ACK yet)
+    uint64_t bytes_sent;
+    uint64_t bytes_received;
+    uint32_t packets_sent;
+    uint32_t packets_received;
+} ClientStats;
+
+// Metrics snapshot (server → localhost admin tool). Clients are paged:
+// a request names the first client slot it wants, the reply carries as
+// many connected clients from there as fit.
+typedef struct {
+    uint32_t tick;
+    uint8_t current_wave;
+    uint16_t client_count;
+    
+    // Tick time over the current profile window
+    uint32_t profile_ticks;
+    uint32_t tick_p50_us;
+    uint32_t tick_p99_us;
+    uint32_t tick_max_us;
+    uint32_t tick_overruns;
+    
+    uint32_t entity_counts[3];    // By EntityType: players, enemies, projectiles
+    
+    // Drops (totals)
+    uint32_t inputs_dropped;      // Input queue full
+    uint32_t projectiles_dropped; // Projectile pool full
+    uint32_t log_dropped;         // Log ring full
+    
+    // Heap (totals, plus the status print's per-second count)
+    uint64_t heap_allocs;
+    uint64_t heap_frees;
+    uint64_t heap_bytes;
+    uint32_t tick_allocs;
+    
+    uint16_t next_client;         // Slot to ask for next (0 = that was the last page)
+    uint8_t client_records;
+    uint8_t client_capacity;
+    ClientStats* clients;
+} StatsMessage;
+
+// STATS wire format:
+//   type(1) tick(4) wave(1) clients(2) profile_ticks(4) p50(4) p99(4) max(4)
+//   overruns(4) players(4) enemies(4) projectiles(4) inputs_dropped(4)
+//   projectiles_dropped(4) log_dropped(4) heap_allocs(8) heap_frees(8)
+//   heap_bytes(8) tick_allocs(4) next_client(2)
+//   client_records(1) { player_id(4) rtt_us(4) bytes_sent(8)
+//                       bytes_received(8) packets_sent(4) packets_received(4) }
+#define STATS_HEADER_SIZE 83
+#define STATS_CLIENT_SIZE 32
+#define STATS_MAX_CLIENTS ((MAX_PACKET_SIZE - STATS_HEADER_SIZE) / STATS_CLIENT_SIZE)
+
+int serialize_stats_request(uint16_t first_client, uint8_t* buffer, int buffer_size);
+int deserialize_stats_request(const uint8_t* buffer, int buffer_size, uint16_t* first_client);
+
+// Writes msg->client_records clients (at most STATS_MAX_CLIENTS)
+int serialize_stats(const StatsMessage* msg, uint8_t* buffer, int buffer_size);
+// Decodes up to msg->client_capacity clients into msg->clients
+int deserialize_stats(const uint8_t* buffer, int buffer_size, StatsMessage* msg);
 
 #endif
\ No newline at end of file
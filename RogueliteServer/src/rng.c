@@ -0,0 +1,49 @@
+#include "rng.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ull
+
+// SplitMix64 finalizer: spreads nearby inputs (consecutive IDs/ticks)
+// across the whole state space
+static uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+void rng_seed(Rng* rng, uint64_t seed, uint64_t stream) {
+    rng->state = 0;
+    rng->inc = (stream << 1) | 1u;
+    rng_next(rng);
+    rng->state += seed;
+    rng_next(rng);
+}
+
+Rng rng_for_entity(uint64_t seed, uint32_t entity_id, uint32_t tick) {
+    Rng rng;
+    rng_seed(&rng, mix64(seed ^ mix64(((uint64_t)entity_id << 32) | tick)), entity_id);
+    return rng;
+}
+
+uint32_t rng_next(Rng* rng) {
+    uint64_t old = rng->state;
+    rng->state = old * PCG_MULTIPLIER + rng->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rot = (uint32_t)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+float rng_float(Rng* rng) {
+    // Top 24 bits: exactly representable, never rounds up to 1.0
+    return (float)(rng_next(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+float rng_range(Rng* rng, float min, float max) {
+    return min + rng_float(rng) * (max - min);
+}
+
+int rng_int(Rng* rng, int min, int max) {
+    if (max <= min) return min;
+    uint32_t span = (uint32_t)(max - min);
+    return min + (int)(((uint64_t)rng_next(rng) * span) >> 32);
+}
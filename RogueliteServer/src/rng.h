@@ -0,0 +1,29 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// PCG32 (XSH-RR): 64-bit LCG state, 32-bit output, selectable stream.
+// Replaces rand(): no hidden global state, so the simulation replays
+// bit for bit from a seed and threads never share a generator.
+typedef struct {
+    uint64_t state;
+    uint64_t inc;              // Stream selector (always odd)
+} Rng;
+
+void rng_seed(Rng* rng, uint64_t seed, uint64_t stream);
+
+// Independent generator for one entity on one tick: a pure function of
+// (seed, entity ID, tick), so the result doesn't depend on update order
+// or on which thread asks.
+Rng rng_for_entity(uint64_t seed, uint32_t entity_id, uint32_t tick);
+
+uint32_t rng_next(Rng* rng);
+float rng_float(Rng* rng);                         // [0, 1)
+float rng_range(Rng* rng, float min, float max);   // [min, max)
+
+// Integer in [min, max) (min if max <= min). Multiply-shift, no rejection:
+// trivially reproducible in other languages (the client's Rng.cs).
+int rng_int(Rng* rng, int min, int max);
+
+#endif
@@ -0,0 +1,105 @@
+#include "snapshot.h"
+#include "memory.h"
+#include <stdio.h>
+#include <string.h>
+
+// Initialize ring (allocates nothing until the first frame is written)
+void snapshot_ring_init(SnapshotRing* ring) {
+    memset(ring, 0, sizeof(*ring));
+}
+
+// Free ring
+void snapshot_ring_free(SnapshotRing* ring) {
+    for (int i = 0; i < SNAPSHOT_RING_SIZE; i++) {
+        mem_free(ring->frames[i].entities);
+        mem_free(ring->frames[i].player_ids);
+    }
+    memset(ring, 0, sizeof(*ring));
+}
+
+// Reset history
+void snapshot_ring_reset(SnapshotRing* ring) {
+    for (int i = 0; i < SNAPSHOT_RING_SIZE; i++) {
+        ring->frames[i].tick = 0;
+        ring->frames[i].entity_count = 0;
+        ring->frames[i].player_count = 0;
+    }
+    ring->acked_tick = 0;
+}
+
+// Acked frame, if it is still in the ring and won't be overwritten by 'tick'
+const ClientFrame* snapshot_ring_baseline(const SnapshotRing* ring, uint32_t tick) {
+    if (ring->acked_tick == 0) return NULL;
+    if (tick - ring->acked_tick >= SNAPSHOT_RING_SIZE) return NULL;
+    
+    const ClientFrame* frame = &ring->frames[ring->acked_tick % SNAPSHOT_RING_SIZE];
+    return frame->tick == ring->acked_tick ? frame : NULL;
+}
+
+// Start the frame for tick
+ClientFrame* snapshot_ring_begin(SnapshotRing* ring, uint32_t tick) {
+    ClientFrame* frame = &ring->frames[tick % SNAPSHOT_RING_SIZE];
+    frame->tick = tick;
+    frame->entity_count = 0;
+    frame->player_count = 0;
+    return frame;
+}
+
+// Record ACK
+const ClientFrame* snapshot_ring_ack(SnapshotRing* ring, uint32_t tick) {
+    if (tick <= ring->acked_tick) return NULL;  // Old or duplicate (packets can arrive out of order)
+    
+    const ClientFrame* frame = &ring->frames[tick % SNAPSHOT_RING_SIZE];
+    if (frame->tick != tick) return NULL;  // Never sent, or already overwritten
+    
+    ring->acked_tick = tick;
+    return frame;
+}
+
+// Append entity (doubling growth)
+bool snapshot_frame_add_entity(ClientFrame* frame, const EntityState* entity) {
+    if (frame->entity_count >= frame->entity_capacity) {
+        size_t new_capacity = frame->entity_capacity ? frame->entity_capacity * 2 : 64;
+        EntityState* entities = mem_realloc(frame->entities, new_capacity * sizeof(EntityState));
+        if (entities == NULL) {
+            fprintf(stderr, "Failed to grow snapshot frame!\n");
+            return false;
+        }
+        frame->entities = entities;
+        frame->entity_capacity = new_capacity;
+    }
+    
+    frame->entities[frame->entity_count++] = *entity;
+    return true;
+}
+
+// Append player ID (doubling growth)
+bool snapshot_frame_add_player(ClientFrame* frame, uint32_t player_id) {
+    if (frame->player_count >= frame->player_capacity) {
+        size_t new_capacity = frame->player_capacity ? frame->player_capacity * 2 : 16;
+        uint32_t* ids = mem_realloc(frame->player_ids, new_capacity * sizeof(uint32_t));
+        if (ids == NULL) {
+            fprintf(stderr, "Failed to grow snapshot frame!\n");
+            return false;
+        }
+        frame->player_ids = ids;
+        frame->player_capacity = new_capacity;
+    }
+    
+    frame->player_ids[frame->player_count++] = player_id;
+    return true;
+}
+
+// Is this player's name already known to the client?
+bool snapshot_frame_has_player(const ClientFrame* frame, uint32_t player_id) {
+    size_t lo = 0, hi = frame->player_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (frame->player_ids[mid] < player_id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < frame->player_count && frame->player_ids[lo] == player_id;
+}
@@ -0,0 +1,55 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "protocol.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Frames of history kept per client (~0.5 s at 60 Hz). A client whose last
+// ack is older than this gets a full state again.
+#define SNAPSHOT_RING_SIZE 32
+
+// What one client holds after applying one STATE packet
+typedef struct {
+    uint32_t tick;              // 0 = unused
+    uint64_t sent_ns;           // timing_now_ns() when built (for the ACK round trip)
+    EntityState* entities;      // Sorted by entity_id
+    size_t entity_count;
+    size_t entity_capacity;
+    uint32_t* player_ids;       // Players whose names the client has, sorted
+    size_t player_count;
+    size_t player_capacity;
+} ClientFrame;
+
+// Per-client ring of sent frames plus the newest one the client acknowledged.
+// Frame buffers grow on demand and are reused, so steady state never allocates.
+typedef struct {
+    ClientFrame frames[SNAPSHOT_RING_SIZE];
+    uint32_t acked_tick;        // 0 = nothing acknowledged yet
+} SnapshotRing;
+
+void snapshot_ring_init(SnapshotRing* ring);
+void snapshot_ring_free(SnapshotRing* ring);
+
+// Forget all history (new session); keeps the buffers
+void snapshot_ring_reset(SnapshotRing* ring);
+
+// Frame to encode tick 'tick' against, or NULL to send a full state
+const ClientFrame* snapshot_ring_baseline(const SnapshotRing* ring, uint32_t tick);
+
+// Clear and return the frame slot for 'tick'
+ClientFrame* snapshot_ring_begin(SnapshotRing* ring, uint32_t tick);
+
+// Record an ACK; returns the newly acknowledged frame (NULL if the ACK was
+// stale or the frame is no longer in the ring)
+const ClientFrame* snapshot_ring_ack(SnapshotRing* ring, uint32_t tick);
+
+// Append in id order; false if growing fails
+bool snapshot_frame_add_entity(ClientFrame* frame, const EntityState* entity);
+bool snapshot_frame_add_player(ClientFrame* frame, uint32_t player_id);
+
+// Binary search over the sorted player list
+bool snapshot_frame_has_player(const ClientFrame* frame, uint32_t player_id);
+
+#endif
@@ -0,0 +1,150 @@
+#include "spatial_hash.h"
+#include "memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Hash a cell coordinate into a bucket index (bucket_count is a power of two)
+static size_t cell_bucket(const SpatialHash* hash, int cx, int cy) {
+    uint32_t h = ((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u);
+    return h & (hash->bucket_count - 1);
+}
+
+// Grow bucket table so it has at least 'needed' buckets (never shrinks)
+static void ensure_buckets(SpatialHash* hash, size_t needed) {
+    if (needed <= hash->bucket_count) return;
+
+    size_t new_count = hash->bucket_count;
+    while (new_count < needed) {
+        new_count *= 2;
+    }
+
+    uint32_t* new_start = mem_realloc(hash->bucket_start, (new_count + 1) * sizeof(uint32_t));
+    if (new_start == NULL) {
+        fprintf(stderr, "Failed to grow spatial hash buckets!\n");
+        exit(1);
+    }
+
+    hash->bucket_start = new_start;
+    hash->bucket_count = new_count;
+}
+
+// Grow entry array so it can hold 'needed' indices (never shrinks)
+static void ensure_entries(SpatialHash* hash, size_t needed) {
+    if (needed <= hash->entry_capacity) return;
+
+    size_t new_capacity = hash->entry_capacity;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+
+    uint32_t* new_entries = mem_realloc(hash->entries, new_capacity * sizeof(uint32_t));
+    if (new_entries == NULL) {
+        fprintf(stderr, "Failed to grow spatial hash entries!\n");
+        exit(1);
+    }
+
+    hash->entries = new_entries;
+    hash->entry_capacity = new_capacity;
+}
+
+// Initialize spatial hash
+void spatial_hash_init(SpatialHash* hash, size_t initial_buckets) {
+    size_t count = 1;
+    while (count < initial_buckets) {
+        count *= 2;
+    }
+
+    hash->bucket_start = mem_alloc((count + 1) * sizeof(uint32_t));
+    hash->entries = mem_alloc(count * sizeof(uint32_t));
+
+    if (hash->bucket_start == NULL || hash->entries == NULL) {
+        fprintf(stderr, "Failed to allocate spatial hash!\n");
+        exit(1);
+    }
+
+    hash->bucket_count = count;
+    hash->entry_count = 0;
+    hash->entry_capacity = count;
+    memset(hash->bucket_start, 0, (count + 1) * sizeof(uint32_t));
+}
+
+// Free spatial hash
+void spatial_hash_free(SpatialHash* hash) {
+    mem_free(hash->bucket_start);
+    mem_free(hash->entries);
+    hash->bucket_start = NULL;
+    hash->entries = NULL;
+    hash->bucket_count = 0;
+    hash->entry_count = 0;
+    hash->entry_capacity = 0;
+}
+
+// Cells overlapped by a box (right/bottom edges are exclusive, like collision_check_aabb)
+CellRange spatial_hash_cells(BoundingBox box) {
+    CellRange range;
+    range.min_x = (int)floorf(box.x / SPATIAL_HASH_CELL_SIZE);
+    range.min_y = (int)floorf(box.y / SPATIAL_HASH_CELL_SIZE);
+    range.max_x = (int)floorf((box.x + box.width) / SPATIAL_HASH_CELL_SIZE);
+    range.max_y = (int)floorf((box.y + box.height) / SPATIAL_HASH_CELL_SIZE);
+    return range;
+}
+
+// Rebuild hash from entity positions (counting sort into buckets)
+void spatial_hash_build(SpatialHash* hash, EntityManager* em) {
+    // Size buckets to ~2x the entity count to keep chains short
+    ensure_buckets(hash, em->count * 2);
+
+    size_t bucket_count = hash->bucket_count;
+    uint32_t* start = hash->bucket_start;
+    memset(start, 0, (bucket_count + 1) * sizeof(uint32_t));
+
+    // Pass 1: count entries per bucket
+    size_t total = 0;
+    for (size_t i = 0; i < em->count; i++) {
+        Entity* e = &em->entities[i];
+        if (!e->active) continue;
+
+        CellRange r = spatial_hash_cells(collision_get_bounds(em, e));
+        for (int cy = r.min_y; cy <= r.max_y; cy++) {
+            for (int cx = r.min_x; cx <= r.max_x; cx++) {
+                start[cell_bucket(hash, cx, cy) + 1]++;
+                total++;
+            }
+        }
+    }
+
+    ensure_entries(hash, total);
+
+    // Pass 2: prefix sum turns counts into start offsets
+    for (size_t b = 0; b < bucket_count; b++) {
+        start[b + 1] += start[b];
+    }
+
+    // Pass 3: scatter entity indices (uses start[b] as a write cursor)
+    for (size_t i = 0; i < em->count; i++) {
+        Entity* e = &em->entities[i];
+        if (!e->active) continue;
+
+        CellRange r = spatial_hash_cells(collision_get_bounds(em, e));
+        for (int cy = r.min_y; cy <= r.max_y; cy++) {
+            for (int cx = r.min_x; cx <= r.max_x; cx++) {
+                hash->entries[start[cell_bucket(hash, cx, cy)]++] = (uint32_t)i;
+            }
+        }
+    }
+
+    // Cursors now sit at each bucket's end; shift back down to restore starts
+    memmove(&start[1], &start[0], bucket_count * sizeof(uint32_t));
+    start[0] = 0;
+
+    hash->entry_count = total;
+}
+
+// Get the run of entity indices for a cell's bucket
+const uint32_t* spatial_hash_bucket(const SpatialHash* hash, int cx, int cy, size_t* count) {
+    size_t b = cell_bucket(hash, cx, cy);
+    *count = hash->bucket_start[b + 1] - hash->bucket_start[b];
+    return &hash->entries[hash->bucket_start[b]];
+}
@@ -0,0 +1,43 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "entity.h"
+#include "collision.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// Cell size matches the 32px player/enemy boxes, so a target overlaps at most 4 cells
+#define SPATIAL_HASH_CELL_SIZE 32.0f
+
+// Uniform-grid spatial hash (broadphase for collision_resolve_all)
+// Cells are hashed into buckets; each bucket holds a contiguous run of entity
+// indices, built with a counting sort so a rebuild never allocates once warm.
+typedef struct {
+    uint32_t* bucket_start;   // bucket_count + 1 offsets into entries
+    size_t bucket_count;      // Always a power of two
+    uint32_t* entries;        // Entity indices grouped by bucket
+    size_t entry_count;
+    size_t entry_capacity;
+} SpatialHash;
+
+// Cell coordinate range covered by a box (inclusive)
+typedef struct {
+    int min_x, min_y;
+    int max_x, max_y;
+} CellRange;
+
+void spatial_hash_init(SpatialHash* hash, size_t initial_buckets);
+void spatial_hash_free(SpatialHash* hash);
+
+// Rebuild from all active entities (call once per tick)
+void spatial_hash_build(SpatialHash* hash, EntityManager* em);
+
+// Cells overlapped by a bounding box
+CellRange spatial_hash_cells(BoundingBox box);
+
+// Entity indices stored in the bucket of cell (cx, cy).
+// The bucket may also contain entities from other cells (hash collisions),
+// so callers must still run the narrowphase test.
+const uint32_t* spatial_hash_bucket(const SpatialHash* hash, int cx, int cy, size_t* count);
+
+#endif
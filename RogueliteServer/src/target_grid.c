@@ -0,0 +1,177 @@
+#include "target_grid.h"
+#include "memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Cell coordinate along one axis, clamped to the grid
+static int cell_coord(float position, float min, int cells) {
+    int c = (int)floorf((position - min) / TARGET_GRID_CELL_SIZE);
+    if (c < 0) return 0;
+    if (c >= cells) return cells - 1;
+    return c;
+}
+
+static size_t cell_of(const TargetGrid* grid, float x, float y) {
+    int cx = cell_coord(x, grid->min_x, grid->cells_x);
+    int cy = cell_coord(y, grid->min_y, grid->cells_y);
+    return (size_t)cy * (size_t)grid->cells_x + (size_t)cx;
+}
+
+static bool is_target(const EntityManager* em, size_t i) {
+    return em->entities[i].type == ENTITY_TYPE_PLAYER && em->entities[i].active;
+}
+
+// Initialize target grid
+void target_grid_init(TargetGrid* grid, float min_x, float min_y, float max_x, float max_y) {
+    grid->min_x = min_x;
+    grid->min_y = min_y;
+    grid->cells_x = (int)ceilf((max_x - min_x) / TARGET_GRID_CELL_SIZE);
+    grid->cells_y = (int)ceilf((max_y - min_y) / TARGET_GRID_CELL_SIZE);
+    if (grid->cells_x < 1) grid->cells_x = 1;
+    if (grid->cells_y < 1) grid->cells_y = 1;
+
+    size_t cells = (size_t)grid->cells_x * (size_t)grid->cells_y;
+    grid->cell_start = mem_alloc((cells + 1) * sizeof(uint32_t));
+    grid->entry_capacity = 64;
+    grid->entries = mem_alloc(grid->entry_capacity * sizeof(uint32_t));
+    grid->player_count = 0;
+
+    if (grid->cell_start == NULL || grid->entries == NULL) {
+        fprintf(stderr, "Failed to allocate target grid!\n");
+        exit(1);
+    }
+    memset(grid->cell_start, 0, (cells + 1) * sizeof(uint32_t));
+}
+
+// Free target grid
+void target_grid_free(TargetGrid* grid) {
+    mem_free(grid->cell_start);
+    mem_free(grid->entries);
+    grid->cell_start = NULL;
+    grid->entries = NULL;
+    grid->entry_capacity = 0;
+    grid->player_count = 0;
+}
+
+// Rebuild grid from the active players (counting sort into cells)
+void target_grid_build(TargetGrid* grid, const EntityManager* em) {
+    size_t cells = (size_t)grid->cells_x * (size_t)grid->cells_y;
+    uint32_t* start = grid->cell_start;
+    memset(start, 0, (cells + 1) * sizeof(uint32_t));
+
+    // Pass 1: count players per cell
+    size_t players = 0;
+    for (size_t i = 0; i < em->count; i++) {
+        if (!is_target(em, i)) continue;
+        start[cell_of(grid, em->pos_x[i], em->pos_y[i]) + 1]++;
+        players++;
+    }
+    grid->player_count = players;
+
+    if (players > grid->entry_capacity) {
+        size_t new_capacity = grid->entry_capacity;
+        while (new_capacity < players) {
+            new_capacity *= 2;
+        }
+        uint32_t* grown = mem_realloc(grid->entries, new_capacity * sizeof(uint32_t));
+        if (grown == NULL) {
+            fprintf(stderr, "Failed to grow target grid!\n");
+            exit(1);
+        }
+        grid->entries = grown;
+        grid->entry_capacity = new_capacity;
+    }
+
+    // Pass 2: prefix sum turns counts into start offsets
+    for (size_t c = 0; c < cells; c++) {
+        start[c + 1] += start[c];
+    }
+
+    // Pass 3: scatter indices (start[c] is the write cursor)
+    for (size_t i = 0; i < em->count; i++) {
+        if (!is_target(em, i)) continue;
+        grid->entries[start[cell_of(grid, em->pos_x[i], em->pos_y[i])]++] = (uint32_t)i;
+    }
+
+    // Cursors now sit at each cell's end; shift back down to restore starts
+    memmove(&start[1], &start[0], cells * sizeof(uint32_t));
+    start[0] = 0;
+}
+
+// Closest candidate in entries [first, last)
+static void scan_run(const TargetGrid* grid, const EntityManager* em, uint32_t first, uint32_t last,
+                     float x, float y, uint32_t* best, float* best_sq) {
+    for (uint32_t k = first; k < last; k++) {
+        uint32_t index = grid->entries[k];
+        float dx = em->pos_x[index] - x;
+        float dy = em->pos_y[index] - y;
+        float d_sq = dx * dx + dy * dy;
+        if (d_sq < *best_sq || (d_sq == *best_sq && index < *best)) {
+            *best = index;
+            *best_sq = d_sq;
+        }
+    }
+}
+
+// Search rings of cells outward from the query's cell, stopping once the
+// next ring can't hold anything closer than the best found: usually after
+// the first ring or two, however many players there are.
+uint32_t target_grid_nearest(const TargetGrid* grid, const EntityManager* em,
+                             float x, float y, float range, float* distance_sq) {
+    uint32_t best = TARGET_NONE;
+    float best_sq = range * range;
+
+    // A handful of players: checking them all beats walking empty cells
+    if (grid->player_count <= TARGET_GRID_LINEAR_MAX) {
+        scan_run(grid, em, 0, (uint32_t)grid->player_count, x, y, &best, &best_sq);
+        *distance_sq = best_sq;
+        return best;
+    }
+
+    int cx = cell_coord(x, grid->min_x, grid->cells_x);
+    int cy = cell_coord(y, grid->min_y, grid->cells_y);
+    int max_ring = (int)ceilf(range / TARGET_GRID_CELL_SIZE) + 1;
+
+    // Gap between (x, y) and the nearest edge of its cell: ring r is at
+    // least margin + (r - 1) cells away
+    float left = x - (grid->min_x + (float)cx * TARGET_GRID_CELL_SIZE);
+    float top = y - (grid->min_y + (float)cy * TARGET_GRID_CELL_SIZE);
+    float margin = fminf(fminf(left, TARGET_GRID_CELL_SIZE - left),
+                         fminf(top, TARGET_GRID_CELL_SIZE - top));
+    if (margin < 0.0f) margin = 0.0f;   // Outside the grid (clamped cell)
+
+    for (int r = 0; r <= max_ring; r++) {
+        if (r > 0) {
+            float ring_distance = margin + (float)(r - 1) * TARGET_GRID_CELL_SIZE;
+            if (ring_distance * ring_distance > best_sq) break;
+        }
+
+        int min_cx = cx - r < 0 ? 0 : cx - r;
+        int max_cx = cx + r >= grid->cells_x ? grid->cells_x - 1 : cx + r;
+        for (int ry = cy - r; ry <= cy + r; ry++) {
+            if (ry < 0 || ry >= grid->cells_y) continue;
+            size_t row = (size_t)ry * (size_t)grid->cells_x;
+
+            if (ry == cy - r || ry == cy + r) {
+                // Top and bottom edges: one contiguous run of cells
+                scan_run(grid, em, grid->cell_start[row + (size_t)min_cx],
+                         grid->cell_start[row + (size_t)max_cx + 1], x, y, &best, &best_sq);
+            } else {
+                // Sides: just the two end cells
+                if (cx - r >= 0) {
+                    size_t c = row + (size_t)(cx - r);
+                    scan_run(grid, em, grid->cell_start[c], grid->cell_start[c + 1], x, y, &best, &best_sq);
+                }
+                if (cx + r < grid->cells_x) {
+                    size_t c = row + (size_t)(cx + r);
+                    scan_run(grid, em, grid->cell_start[c], grid->cell_start[c + 1], x, y, &best, &best_sq);
+                }
+            }
+        }
+    }
+
+    *distance_sq = best_sq;
+    return best;
+}
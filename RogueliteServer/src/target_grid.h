@@ -0,0 +1,39 @@
+#ifndef TARGET_GRID_H
+#define TARGET_GRID_H
+
+#include "entity.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define TARGET_GRID_CELL_SIZE 128.0f
+#define TARGET_GRID_LINEAR_MAX 32   // Up to this many players, queries just scan them all
+#define TARGET_NONE UINT32_MAX
+
+// Uniform grid of active players for the AI's nearest-target queries.
+// Rebuilt once a tick (counting sort, like InterestGrid); queries are
+// read-only, so the AI decision phase can run them from any thread.
+typedef struct {
+    float min_x, min_y;       // World position of cell (0, 0)
+    int cells_x, cells_y;
+    uint32_t* cell_start;     // cells_x * cells_y + 1 offsets into entries
+    uint32_t* entries;        // Player entity indices grouped by cell
+    size_t entry_capacity;
+    size_t player_count;
+} TargetGrid;
+
+// Covers [min, max]; players outside are counted in the nearest edge cell
+void target_grid_init(TargetGrid* grid, float min_x, float min_y, float max_x, float max_y);
+void target_grid_free(TargetGrid* grid);
+
+// Rebuild from the active players in em
+void target_grid_build(TargetGrid* grid, const EntityManager* em);
+
+// Entity index of the nearest player within range of (x, y), or
+// TARGET_NONE; *distance_sq gets its squared distance. Searches outward
+// from (x, y) and stops as soon as no closer player can remain, so the
+// cost depends on local density rather than player count. Ties go to the
+// lower index, so the answer never depends on scan order.
+uint32_t target_grid_nearest(const TargetGrid* grid, const EntityManager* em,
+                             float x, float y, float range, float* distance_sq);
+
+#endif
@@ -0,0 +1,163 @@
+#include "tile_collision.h"
+#include "collision.h"
+#include <stdlib.h>
+#include <math.h>
+
+#define TILE ((float)DUNGEON_TILE_SIZE)
+#define INV_TILE (1.0f / TILE)
+
+// floorf/ceilf to int without the libm call (values stay far inside int range)
+static inline int floor_int(float v) {
+    int i = (int)v;
+    return i - (v < (float)i);
+}
+
+static inline int ceil_int(float v) {
+    int i = (int)v;
+    return i + (v > (float)i);
+}
+
+// Overlaps thinner than this don't count. Without it, float drift leaves
+// a box a hair over a wall edge, where steering too small to register can
+// never free it.
+#define TILE_SKIN 0.01f
+
+// Tile span [first, last] covered by [start, start + size) on one axis
+// (map-local pixels); a box ending exactly on a tile edge doesn't reach the next tile
+static int span_first(float start) {
+    return floor_int((start + TILE_SKIN) * INV_TILE);
+}
+
+static int span_last(float start, float size) {
+    return ceil_int((start + size - TILE_SKIN) * INV_TILE) - 1;
+}
+
+// Any wall in column 'line' (vertical) or row 'line' over tiles [first, last]?
+static bool line_blocked(const Dungeon* dungeon, bool vertical, int line, int first, int last) {
+    for (int i = first; i <= last; i++) {
+        bool walkable = vertical ? dungeon_tile_walkable(dungeon, line, i)
+                                 : dungeon_tile_walkable(dungeon, i, line);
+        if (!walkable) return true;
+    }
+    return false;
+}
+
+// Move [*pos, *pos + size) by delta along one axis, checking each tile line
+// the leading edge enters; [first, last] is the span on the other axis.
+// Returns true (with *pos flush against the wall) if a wall stopped it.
+static bool sweep_axis(const Dungeon* dungeon, bool vertical, float* pos, float delta,
+                       float size, int first, int last) {
+    if (delta > 0.0f) {
+        int from = span_last(*pos, size) + 1;
+        int to = span_last(*pos + delta, size);
+        for (int line = from; line <= to; line++) {
+            if (line_blocked(dungeon, vertical, line, first, last)) {
+                *pos = (float)line * TILE - size;
+                return true;
+            }
+        }
+    } else if (delta < 0.0f) {
+        int from = span_first(*pos) - 1;
+        int to = span_first(*pos + delta);
+        for (int line = from; line >= to; line--) {
+            if (line_blocked(dungeon, vertical, line, first, last)) {
+                *pos = (float)(line + 1) * TILE;
+                return true;
+            }
+        }
+    }
+    *pos += delta;
+    return false;
+}
+
+void tile_collision_move_entities(EntityManager* em, const Dungeon* dungeon, float delta_time) {
+    float* pos_x = em->pos_x;
+    float* pos_y = em->pos_y;
+    float* vel_x = em->vel_x;
+    float* vel_y = em->vel_y;
+
+    for (size_t i = 0; i < em->count; i++) {
+        if (vel_x[i] == 0.0f && vel_y[i] == 0.0f) continue;
+
+        float size = em->entities[i].type == ENTITY_TYPE_PLAYER ? PLAYER_SIZE : ENEMY_SIZE;
+        float x = pos_x[i] - dungeon->origin_x;
+        float y = pos_y[i] - dungeon->origin_y;
+
+        // X across the rows the box spans now, then Y across the columns it spans after
+        if (sweep_axis(dungeon, true, &x, vel_x[i] * delta_time, size,
+                       span_first(y), span_last(y, size))) {
+            vel_x[i] = 0.0f;
+        }
+        if (sweep_axis(dungeon, false, &y, vel_y[i] * delta_time, size,
+                       span_first(x), span_last(x, size))) {
+            vel_y[i] = 0.0f;
+        }
+
+        pos_x[i] = x + dungeon->origin_x;
+        pos_y[i] = y + dungeon->origin_y;
+    }
+}
+
+// Amanatides & Woo: step into whichever neighbouring tile the segment
+// reaches first, so every tile it touches is visited exactly once
+bool tile_collision_raycast(const Dungeon* dungeon, float x0, float y0, float x1, float y1,
+                            float* hit_fraction) {
+    // Segment in tile units
+    float start_x = (x0 - dungeon->origin_x) * INV_TILE;
+    float start_y = (y0 - dungeon->origin_y) * INV_TILE;
+    float dx = (x1 - x0) * INV_TILE;
+    float dy = (y1 - y0) * INV_TILE;
+
+    int tx = floor_int(start_x);
+    int ty = floor_int(start_y);
+    if (!dungeon_tile_walkable(dungeon, tx, ty)) {
+        *hit_fraction = 0.0f;
+        return true;
+    }
+
+    int step_x = dx > 0.0f ? 1 : -1;
+    int step_y = dy > 0.0f ? 1 : -1;
+    // Segment fraction per tile crossed, and to the first crossing, on each axis
+    float delta_x = dx != 0.0f ? fabsf(1.0f / dx) : INFINITY;
+    float delta_y = dy != 0.0f ? fabsf(1.0f / dy) : INFINITY;
+    float next_x = dx > 0.0f ? ((float)(tx + 1) - start_x) * delta_x
+                 : dx < 0.0f ? (start_x - (float)tx) * delta_x : INFINITY;
+    float next_y = dy > 0.0f ? ((float)(ty + 1) - start_y) * delta_y
+                 : dy < 0.0f ? (start_y - (float)ty) * delta_y : INFINITY;
+
+    // Exactly one tile boundary per step, so the end tile bounds the walk
+    int steps = abs(floor_int(start_x + dx) - tx) + abs(floor_int(start_y + dy) - ty);
+    for (int s = 0; s < steps; s++) {
+        float t;
+        if (next_x < next_y) {
+            tx += step_x;
+            t = next_x;
+            next_x += delta_x;
+        } else {
+            ty += step_y;
+            t = next_y;
+            next_y += delta_y;
+        }
+        if (!dungeon_tile_walkable(dungeon, tx, ty)) {
+            *hit_fraction = t < 1.0f ? t : 1.0f;
+            return true;
+        }
+    }
+    return false;
+}
+
+void tile_collision_projectiles(ProjectilePool* pool, const Dungeon* dungeon, float delta_time) {
+    const float half = PROJECTILE_SIZE * 0.5f;
+
+    for (size_t i = 0; i < pool->count; i++) {
+        if (!pool->active[i]) continue;
+
+        float x = pool->pos_x[i] + half;
+        float y = pool->pos_y[i] + half;
+        float hit_fraction;
+        if (tile_collision_raycast(dungeon, x, y, x + pool->vel_x[i] * delta_time,
+                                   y + pool->vel_y[i] * delta_time, &hit_fraction)) {
+            pool->active[i] = false;
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef TILE_COLLISION_H
+#define TILE_COLLISION_H
+
+#include "entity.h"
+#include "projectile_pool.h"
+#include "dungeon.h"
+#include <stdbool.h>
+
+// Wall collision against the dungeon's walkability bitmap. Both passes are
+// swept, so nothing tunnels through a wall however far it moves in a tick.
+
+// Integrate players and enemies (replaces entity_update_all) with swept
+// AABB-vs-tile resolution: X first, then Y, each stopping flush against the
+// first wall tile the box's leading edge would enter and zeroing velocity on
+// that axis, so entities slide along walls. Tiles the box already overlaps
+// are ignored, so anything placed inside a wall can still walk out.
+void tile_collision_move_entities(EntityManager* em, const Dungeon* dungeon, float delta_time);
+
+// Walk the tiles crossed by the segment (x0, y0) -> (x1, y1) in order (DDA).
+// Returns true at the first wall tile (including the start tile) and sets
+// *hit_fraction to how far along the segment (0-1) it was entered.
+bool tile_collision_raycast(const Dungeon* dungeon, float x0, float y0, float x1, float y1,
+                            float* hit_fraction);
+
+// Deactivate every projectile whose centre would hit a wall this tick.
+// Runs before projectile_pool_update integrates the same step.
+void tile_collision_projectiles(ProjectilePool* pool, const Dungeon* dungeon, float delta_time);
+
+#endif
@@ -0,0 +1,57 @@
+#define _POSIX_C_SOURCE 200809L  // clock_gettime / clock_nanosleep under -std=c11
+#include "timing.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+uint64_t timing_now_ns(void) {
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    
+    // Split to avoid overflowing counter * 1e9
+    uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+    uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+    return seconds * NS_PER_SECOND + remainder * NS_PER_SECOND / (uint64_t)frequency.QuadPart;
+}
+
+void timing_sleep_until_ns(uint64_t deadline_ns) {
+    // No absolute sleep on Windows: sleep whole milliseconds, then spin the rest
+    uint64_t now = timing_now_ns();
+    while (now < deadline_ns) {
+        uint64_t remaining_ms = (deadline_ns - now) / 1000000ull;
+        if (remaining_ms > 1) {
+            Sleep((DWORD)(remaining_ms - 1));
+        }
+        now = timing_now_ns();
+    }
+}
+
+#else
+#include <time.h>
+#include <errno.h>
+
+uint64_t timing_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SECOND + (uint64_t)ts.tv_nsec;
+}
+
+void timing_sleep_until_ns(uint64_t deadline_ns) {
+    struct timespec deadline;
+    deadline.tv_sec = (time_t)(deadline_ns / NS_PER_SECOND);
+    deadline.tv_nsec = (long)(deadline_ns % NS_PER_SECOND);
+    
+    // Restart on signals; an absolute deadline makes that safe
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+    }
+}
+#endif
+
+double timing_now_seconds(void) {
+    return (double)timing_now_ns() / (double)NS_PER_SECOND;
+}
@@ -0,0 +1,18 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdint.h>
+
+#define NS_PER_SECOND 1000000000ull
+
+// Monotonic clock in nanoseconds (unaffected by wall-clock changes)
+uint64_t timing_now_ns(void);
+
+// Monotonic clock in seconds (same origin as timing_now_ns)
+double timing_now_seconds(void);
+
+// Sleep until an absolute timing_now_ns() deadline.
+// Absolute deadlines don't accumulate drift from late wakeups.
+void timing_sleep_until_ns(uint64_t deadline_ns);
+
+#endif
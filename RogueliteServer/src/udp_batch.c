@@ -0,0 +1,236 @@
+#ifndef _WIN32
+#define _GNU_SOURCE  // recvmmsg / sendmmsg
+#endif
+#include "udp_batch.h"
+#include "memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if UDP_HAVE_MMSG
+#include <sys/uio.h>
+#include <errno.h>
+
+// Kernel-facing headers, one per packet
+typedef struct {
+    struct mmsghdr* headers;
+    struct iovec* iov;
+} MmsgArrays;
+#endif
+
+// Initialize batch (the only allocations it makes)
+void udp_batch_init(UdpBatch* batch, int capacity, int buffer_size) {
+    batch->packets = mem_alloc((size_t)capacity * sizeof(UdpPacket));
+    batch->storage = NULL;
+    batch->native = NULL;
+    
+    if (batch->packets == NULL) {
+        fprintf(stderr, "Failed to allocate UDP batch!\n");
+        exit(1);
+    }
+    
+    if (buffer_size > 0) {
+        batch->storage = mem_alloc((size_t)capacity * (size_t)buffer_size);
+        if (batch->storage == NULL) {
+            fprintf(stderr, "Failed to allocate UDP receive buffers!\n");
+            exit(1);
+        }
+        for (int i = 0; i < capacity; i++) {
+            batch->packets[i].data = batch->storage + (size_t)i * (size_t)buffer_size;
+        }
+    }
+    
+#if UDP_HAVE_MMSG
+    MmsgArrays* arrays = mem_alloc(sizeof(MmsgArrays));
+    if (arrays == NULL) {
+        fprintf(stderr, "Failed to allocate UDP batch headers!\n");
+        exit(1);
+    }
+    arrays->headers = mem_alloc((size_t)capacity * sizeof(struct mmsghdr));
+    arrays->iov = mem_alloc((size_t)capacity * sizeof(struct iovec));
+    if (arrays->headers == NULL || arrays->iov == NULL) {
+        fprintf(stderr, "Failed to allocate UDP batch headers!\n");
+        exit(1);
+    }
+    batch->native = arrays;
+#endif
+    
+    batch->count = 0;
+    batch->capacity = capacity;
+    batch->buffer_size = buffer_size;
+    batch->use_mmsg = UDP_HAVE_MMSG;
+    batch->syscalls = 0;
+    batch->packets_moved = 0;
+}
+
+// Free batch
+void udp_batch_free(UdpBatch* batch) {
+#if UDP_HAVE_MMSG
+    MmsgArrays* arrays = batch->native;
+    if (arrays) {
+        mem_free(arrays->headers);
+        mem_free(arrays->iov);
+        mem_free(arrays);
+    }
+#endif
+    mem_free(batch->packets);
+    mem_free(batch->storage);
+    batch->packets = NULL;
+    batch->storage = NULL;
+    batch->native = NULL;
+    batch->count = 0;
+    batch->capacity = 0;
+}
+
+// Fallback: one recvfrom per datagram
+static int recv_portable(SOCKET sock, UdpBatch* batch) {
+    int received = 0;
+    
+    while (received < batch->capacity) {
+        UdpPacket* packet = &batch->packets[received];
+        socklen_t addr_len = sizeof(packet->addr);
+        
+        int len = recvfrom(sock, (char*)packet->data, batch->buffer_size, 0,
+                           (struct sockaddr*)&packet->addr, &addr_len);
+        batch->syscalls++;
+        if (len < 0) break;  // No more packets
+        if (len == 0) continue;  // Empty datagram: reuse the slot
+        
+        packet->length = len;
+        received++;
+    }
+    
+    return received;
+}
+
+// Fallback: one sendto per datagram
+static int send_portable(SOCKET sock, UdpBatch* batch) {
+    int sent = 0;
+    
+    for (int i = 0; i < batch->count; i++) {
+        UdpPacket* packet = &batch->packets[i];
+        int result = sendto(sock, (const char*)packet->data, packet->length, 0,
+                            (struct sockaddr*)&packet->addr, sizeof(packet->addr));
+        batch->syscalls++;
+        if (result >= 0) sent++;
+    }
+    
+    return sent;
+}
+
+#if UDP_HAVE_MMSG
+// One recvmmsg for the whole batch
+static int recv_mmsg(SOCKET sock, UdpBatch* batch) {
+    MmsgArrays* arrays = batch->native;
+    
+    for (int i = 0; i < batch->capacity; i++) {
+        UdpPacket* packet = &batch->packets[i];
+        struct msghdr* hdr = &arrays->headers[i].msg_hdr;
+        
+        arrays->iov[i].iov_base = packet->data;
+        arrays->iov[i].iov_len = (size_t)batch->buffer_size;
+        
+        memset(hdr, 0, sizeof(*hdr));
+        hdr->msg_name = &packet->addr;
+        hdr->msg_namelen = sizeof(packet->addr);
+        hdr->msg_iov = &arrays->iov[i];
+        hdr->msg_iovlen = 1;
+    }
+    
+    int received = recvmmsg(sock, arrays->headers, (unsigned int)batch->capacity, MSG_DONTWAIT, NULL);
+    batch->syscalls++;
+    
+    if (received < 0) {
+        if (errno == ENOSYS) {
+            batch->use_mmsg = false;  // Old kernel: stay on the fallback from now on
+            return recv_portable(sock, batch);
+        }
+        return 0;
+    }
+    
+    for (int i = 0; i < received; i++) {
+        batch->packets[i].length = (int)arrays->headers[i].msg_len;
+    }
+    return received;
+}
+
+// sendmmsg in chunks of the whole batch (usually one call per tick)
+static int send_mmsg(SOCKET sock, UdpBatch* batch) {
+    MmsgArrays* arrays = batch->native;
+    
+    for (int i = 0; i < batch->count; i++) {
+        UdpPacket* packet = &batch->packets[i];
+        struct msghdr* hdr = &arrays->headers[i].msg_hdr;
+        
+        arrays->iov[i].iov_base = packet->data;
+        arrays->iov[i].iov_len = (size_t)packet->length;
+        
+        memset(hdr, 0, sizeof(*hdr));
+        hdr->msg_name = &packet->addr;
+        hdr->msg_namelen = sizeof(packet->addr);
+        hdr->msg_iov = &arrays->iov[i];
+        hdr->msg_iovlen = 1;
+    }
+    
+    // sendmmsg may stop early (full socket buffer or a failed datagram);
+    // skip the failed one and carry on
+    int sent = 0;
+    int next = 0;
+    while (next < batch->count) {
+        int result = sendmmsg(sock, &arrays->headers[next], (unsigned int)(batch->count - next), 0);
+        batch->syscalls++;
+        
+        if (result < 0) {
+            if (errno == ENOSYS) {
+                batch->use_mmsg = false;
+                return sent + send_portable(sock, batch);
+            }
+            next++;  // Drop this datagram, like a failed sendto
+            continue;
+        }
+        
+        sent += result;
+        next += result;
+    }
+    
+    return sent;
+}
+#endif
+
+// Receive a batch of datagrams
+int udp_recv_batch(SOCKET sock, UdpBatch* batch) {
+    int received;
+    
+#if UDP_HAVE_MMSG
+    if (batch->use_mmsg) {
+        received = recv_mmsg(sock, batch);
+    } else {
+        received = recv_portable(sock, batch);
+    }
+#else
+    received = recv_portable(sock, batch);
+#endif
+    
+    batch->count = received;
+    batch->packets_moved += (uint64_t)received;
+    return received;
+}
+
+// Send the queued batch
+int udp_send_batch(SOCKET sock, UdpBatch* batch) {
+    int sent;
+    
+#if UDP_HAVE_MMSG
+    if (batch->use_mmsg) {
+        sent = send_mmsg(sock, batch);
+    } else {
+        sent = send_portable(sock, batch);
+    }
+#else
+    sent = send_portable(sock, batch);
+#endif
+    
+    batch->count = 0;
+    batch->packets_moved += (uint64_t)sent;
+    return sent;
+}
@@ -0,0 +1,56 @@
+#ifndef UDP_BATCH_H
+#define UDP_BATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    typedef int socklen_t;
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    typedef int SOCKET;
+    #define INVALID_SOCKET -1
+#endif
+
+// recvmmsg/sendmmsg are Linux-only; build with -DUDP_NO_MMSG to force the fallback
+#if defined(__linux__) && !defined(UDP_NO_MMSG)
+    #define UDP_HAVE_MMSG 1
+#else
+    #define UDP_HAVE_MMSG 0
+#endif
+
+// One datagram in a batch
+typedef struct {
+    uint8_t* data;              // Receive: points into the batch's storage. Send: caller's buffer
+    int length;
+    struct sockaddr_in addr;    // Receive: sender. Send: destination
+} UdpPacket;
+
+// Batch of datagrams moved with as few syscalls as possible.
+// Everything is allocated once at init; receive/send never allocate.
+typedef struct {
+    UdpPacket* packets;
+    int count;
+    int capacity;
+    uint8_t* storage;           // capacity receive buffers of buffer_size bytes (NULL for send batches)
+    int buffer_size;
+    void* native;               // mmsghdr/iovec arrays (only when UDP_HAVE_MMSG)
+    bool use_mmsg;              // false = one recvfrom/sendto per datagram
+    
+    uint64_t syscalls;          // Lifetime counters
+    uint64_t packets_moved;
+} UdpBatch;
+
+// buffer_size > 0 makes a receive batch with its own packet buffers
+void udp_batch_init(UdpBatch* batch, int capacity, int buffer_size);
+void udp_batch_free(UdpBatch* batch);
+
+// Receive up to capacity datagrams without blocking; returns how many (0 if none)
+int udp_recv_batch(SOCKET sock, UdpBatch* batch);
+
+// Send packets[0..count) and reset count; returns how many were sent
+int udp_send_batch(SOCKET sock, UdpBatch* batch);
+
+#endif
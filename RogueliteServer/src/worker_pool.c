@@ -0,0 +1,230 @@
+#define _POSIX_C_SOURCE 200809L  // sched_yield under -std=c11
+#include "worker_pool.h"
+#include "memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Polls of the job generation before a worker blocks. Back-to-back jobs
+// (one tick's phases, the headless benchmark) then start without a
+// kernel wakeup; an idle server still sleeps.
+#define WORKER_SPIN_LIMIT 4096
+
+struct WorkerShared {
+#ifdef _WIN32
+    HANDLE* threads;
+    SRWLOCK lock;
+    CONDITION_VARIABLE wake;
+#else
+    pthread_t* threads;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+#endif
+    int worker_count;                // Threads besides the caller
+
+    // Current job (written before the generation bump that publishes it)
+    WorkerJob job;
+    void* context;
+    size_t count;
+    size_t chunk;
+
+    _Atomic size_t next;             // Start of the next unclaimed chunk
+    _Atomic int pending;             // Workers not yet finished with this job
+    _Atomic unsigned generation;     // Bumped once per job
+    _Atomic bool stopping;
+};
+
+static void cpu_relax(void) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#endif
+}
+
+static void thread_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// Claim and run chunks until the range is used up
+static void run_chunks(WorkerShared* shared) {
+    for (;;) {
+        size_t begin = atomic_fetch_add_explicit(&shared->next, shared->chunk, memory_order_relaxed);
+        if (begin >= shared->count) return;
+        size_t end = begin + shared->chunk;
+        if (end > shared->count) end = shared->count;
+        shared->job(shared->context, begin, end);
+    }
+}
+
+// Spin briefly, then sleep until the generation moves past 'seen'
+static void wait_for_job(WorkerShared* shared, unsigned seen) {
+    for (int spin = 0; spin < WORKER_SPIN_LIMIT; spin++) {
+        if (atomic_load_explicit(&shared->generation, memory_order_acquire) != seen) return;
+        cpu_relax();
+    }
+
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&shared->lock);
+    while (atomic_load_explicit(&shared->generation, memory_order_acquire) == seen) {
+        SleepConditionVariableSRW(&shared->wake, &shared->lock, INFINITE, 0);
+    }
+    ReleaseSRWLockExclusive(&shared->lock);
+#else
+    pthread_mutex_lock(&shared->lock);
+    while (atomic_load_explicit(&shared->generation, memory_order_acquire) == seen) {
+        pthread_cond_wait(&shared->wake, &shared->lock);
+    }
+    pthread_mutex_unlock(&shared->lock);
+#endif
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker_main(LPVOID arg) {
+#else
+static void* worker_main(void* arg) {
+#endif
+    WorkerShared* shared = arg;
+    unsigned seen = 0;  // Generation at creation: a job published before we got here still counts
+
+    for (;;) {
+        wait_for_job(shared, seen);
+        seen = atomic_load_explicit(&shared->generation, memory_order_acquire);
+        if (atomic_load_explicit(&shared->stopping, memory_order_acquire)) break;
+
+        run_chunks(shared);
+        atomic_fetch_sub_explicit(&shared->pending, 1, memory_order_release);
+    }
+    return 0;
+}
+
+// Publish the job that's been written to 'shared' and wake everyone
+static void publish(WorkerShared* shared) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&shared->lock);
+    atomic_fetch_add_explicit(&shared->generation, 1, memory_order_release);
+    ReleaseSRWLockExclusive(&shared->lock);
+    WakeAllConditionVariable(&shared->wake);
+#else
+    pthread_mutex_lock(&shared->lock);
+    atomic_fetch_add_explicit(&shared->generation, 1, memory_order_release);
+    pthread_mutex_unlock(&shared->lock);
+    pthread_cond_broadcast(&shared->wake);
+#endif
+}
+
+void worker_pool_init(WorkerPool* pool, int thread_count) {
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > WORKER_POOL_MAX_THREADS) thread_count = WORKER_POOL_MAX_THREADS;
+    pool->thread_count = thread_count;
+    pool->shared = NULL;
+    if (thread_count == 1) return;
+
+    WorkerShared* shared = mem_alloc(sizeof(WorkerShared));
+    if (shared == NULL) {
+        fprintf(stderr, "Failed to allocate worker pool!\n");
+        exit(1);
+    }
+    shared->worker_count = thread_count - 1;
+    shared->threads = mem_alloc((size_t)shared->worker_count * sizeof(shared->threads[0]));
+    if (shared->threads == NULL) {
+        fprintf(stderr, "Failed to allocate worker threads!\n");
+        exit(1);
+    }
+    shared->job = NULL;
+    shared->context = NULL;
+    shared->count = 0;
+    shared->chunk = 1;
+    atomic_init(&shared->next, 0);
+    atomic_init(&shared->pending, 0);
+    atomic_init(&shared->generation, 0);
+    atomic_init(&shared->stopping, false);
+
+#ifdef _WIN32
+    InitializeSRWLock(&shared->lock);
+    InitializeConditionVariable(&shared->wake);
+#else
+    pthread_mutex_init(&shared->lock, NULL);
+    pthread_cond_init(&shared->wake, NULL);
+#endif
+
+    for (int i = 0; i < shared->worker_count; i++) {
+#ifdef _WIN32
+        shared->threads[i] = CreateThread(NULL, 0, worker_main, shared, 0, NULL);
+        bool started = shared->threads[i] != NULL;
+#else
+        bool started = pthread_create(&shared->threads[i], NULL, worker_main, shared) == 0;
+#endif
+        if (!started) {
+            fprintf(stderr, "Failed to start worker thread %d!\n", i);
+            exit(1);
+        }
+    }
+    pool->shared = shared;
+}
+
+void worker_pool_free(WorkerPool* pool) {
+    WorkerShared* shared = pool->shared;
+    if (shared == NULL) return;
+
+    atomic_store_explicit(&shared->stopping, true, memory_order_release);
+    publish(shared);
+    for (int i = 0; i < shared->worker_count; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(shared->threads[i], INFINITE);
+        CloseHandle(shared->threads[i]);
+#else
+        pthread_join(shared->threads[i], NULL);
+#endif
+    }
+#ifndef _WIN32
+    pthread_mutex_destroy(&shared->lock);
+    pthread_cond_destroy(&shared->wake);
+#endif
+    mem_free(shared->threads);
+    mem_free(shared);
+    pool->shared = NULL;
+    pool->thread_count = 1;
+}
+
+void worker_pool_run(WorkerPool* pool, WorkerJob job, void* context,
+                     size_t count, size_t chunk) {
+    if (count == 0) return;
+    if (chunk == 0) chunk = 1;
+
+    WorkerShared* shared = pool->shared;
+    if (shared == NULL || count < 2 * chunk) {
+        job(context, 0, count);
+        return;
+    }
+
+    shared->job = job;
+    shared->context = context;
+    shared->count = count;
+    shared->chunk = chunk;
+    atomic_store_explicit(&shared->next, 0, memory_order_relaxed);
+    atomic_store_explicit(&shared->pending, shared->worker_count, memory_order_relaxed);
+    publish(shared);
+
+    run_chunks(shared);
+
+    // Every worker must check in before the job fields can be reused
+    int spins = 0;
+    while (atomic_load_explicit(&shared->pending, memory_order_acquire) != 0) {
+        if (++spins < WORKER_SPIN_LIMIT) {
+            cpu_relax();
+        } else {
+            thread_yield();
+        }
+    }
+}
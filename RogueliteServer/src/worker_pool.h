@@ -0,0 +1,30 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stddef.h>
+
+// Fixed pool of worker threads for data-parallel loops. worker_pool_run
+// splits [0, count) into chunks that the workers and the calling thread
+// take in turn, and returns when every chunk is done. Which thread runs
+// which chunk varies, so jobs must write only to their own range.
+#define WORKER_POOL_MAX_THREADS 64
+
+typedef void (*WorkerJob)(void* context, size_t begin, size_t end);
+
+typedef struct WorkerShared WorkerShared;   // Threads and sync state (worker_pool.c)
+
+typedef struct {
+    int thread_count;                       // Including the calling thread
+    WorkerShared* shared;                   // NULL when single-threaded
+} WorkerPool;
+
+// thread_count 1 runs every job inline with no threads
+void worker_pool_init(WorkerPool* pool, int thread_count);
+void worker_pool_free(WorkerPool* pool);
+
+// Run job over [0, count) in chunks of 'chunk' items. Ranges smaller than
+// two chunks run inline: waking the workers costs more than they'd save.
+void worker_pool_run(WorkerPool* pool, WorkerJob job, void* context,
+                     size_t count, size_t chunk);
+
+#endif